@@ -1,36 +1,98 @@
 #pragma once
+#include "Core/FrameLimiter.hpp"
+#include "Core/FramePacket.hpp"
+#include "Core/JobSystem.hpp"
 #include "Graphics/Vulkan/Context.hpp"
 
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_raii.hpp>
 
+#include <exception>
+#include <filesystem>
+
+struct ApplicationConfig {
+    bool headless = false;
+    uint32_t width = 800;
+    uint32_t height = 600;
+    uint32_t imageCount = 3;   // offscreen images in headless mode
+    uint32_t framesInFlight = 2;
+    uint64_t frameCount = 0;   // 0 runs until the window is closed
+    bool pipelineStatistics = false;
+    uint32_t workerThreads = 0;  // job system workers, 0 uses every hardware thread
+    bool pinWorkers = true;
+    bool pipelined = false;  // simulate the next frame on its own thread while the current one renders
+
+    // Pacing
+    vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;  // FIFO when unsupported
+    double frameRateLimit = 0.0;                                    // 0 is unlimited
+    double backgroundFrameRate = 15.0;                              // limit while unfocused, 0 is unlimited
+    bool lowLatency = false;  // wait for the previous frame to be displayed before sampling input
+
+    std::filesystem::path memoryJson{};  // VMA statistics written here at shutdown when set
+    bool defragment = true;              // move relocatable buffers out of fragmented device memory
+    uint32_t streamBudget = 16;          // MiB of streamed data copied per frame
+};
+
+[[nodiscard]] ApplicationConfig ParseCommandLine(int argc, char** argv);
+
 class Application {
    public:
-    void Run();
+    void Run(const ApplicationConfig& config = {});
     virtual ~Application();
 
     bool mFramebufferResized = false;
 
    protected:
     virtual void onInit(){};
+    // Fills frame packet `packet` for the renderer. Runs off the main thread, so it must not call into GLFW: as a
+    // job overlapping the wait for the frame slot, or with ApplicationConfig::pipelined on the simulation
+    // thread, one frame ahead of rendering. The default forwards to onUpdate for applications without packets.
+    virtual void onSimulate(float dt, uint32_t packet) { onUpdate(dt); }
     virtual void onUpdate(float dt){};
+    // Records work that must happen outside the render pass, such as compute culling, before onRender. Only these
+    // two may allocate from ctx().transientBuffer, which is recycled for the frame after onSimulate has run.
+    virtual void onPreRender(vk::raii::CommandBuffer& cmd, uint32_t imageIndex){};
     virtual void onRender(vk::raii::CommandBuffer& cmd, uint32_t imageIndex){};
     virtual void onShutdown(){};
+    // Return true when onRender records its draws through ctx().recorder. The render pass is then begun for
+    // secondary command buffers, and onRender may only execute them.
+    virtual bool recordsInParallel() const { return false; }
 
     GLFWwindow* window() const { return pWindow; }
+    const ApplicationConfig& config() const { return mConfig; }
+    Solaris::JobSystem& jobs() { return mJobs; }
     Solaris::Graphics::Vulkan::Context& ctx() { return mContext; }
     const Solaris::Graphics::Vulkan::Context& ctx() const { return mContext; }
     const std::chrono::steady_clock::time_point lastTick() const { return mLastTick; }
+    // Slot of the frame packet being rendered, valid in onPreRender and onRender.
+    [[nodiscard]] uint32_t renderPacket() const { return mRenderPacket; }
+    // Inheritance for secondary command buffers recorded inside the main render pass.
+    [[nodiscard]] vk::CommandBufferInheritanceInfo renderPassInheritance(uint32_t imageIndex) const;
 
    private:
     void initLogger();
     void initWindow();
     void initVulkan();
     void mainLoop();
+    // Returns false while the window is minimized, after waiting for events.
+    [[nodiscard]] bool paceFrame();
+    [[nodiscard]] bool simulate(float dt, uint32_t packet);
+    void simulationLoop();
+    [[nodiscard]] bool shouldClose(uint64_t frame) const;
     void recordCommandBuffer(const vk::raii::CommandBuffer& commandBuffer, uint32_t imageIndex);
-    void drawFrame();
+    // Returns false when the frame was skipped without a submit, e.g. on an out-of-date swapchain.
+    [[nodiscard]] bool drawFrame();
 
+    ApplicationConfig mConfig{};
     GLFWwindow* pWindow = nullptr;
+    // Declared before the context so that it outlives everything recording on its workers.
+    Solaris::JobSystem mJobs;
+    Solaris::JobCounter mUpdateJob;
+    Solaris::FramePacketExchange mPackets;
+    uint32_t mRenderPacket = 0;
+    Solaris::FrameLimiter mLimiter;
+    bool mSwapchainOutOfDate = false;
+    std::exception_ptr mSimulationError;  // set before the exchange is closed by a failed simulation
     Solaris::Graphics::Vulkan::Context mContext;
     std::chrono::steady_clock::time_point mLastTick{};
 };
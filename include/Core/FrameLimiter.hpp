@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+
+namespace Solaris {
+
+// Paces the frame loop to a target rate. Sleeping alone wakes up late by the scheduler's latency, often a
+// millisecond or more, so wait() sleeps until shortly before the deadline and spins the rest. The spin margin
+// follows the oversleep actually observed, keeping the spin as short as the system allows.
+class FrameLimiter {
+   public:
+    // 0 disables the limiter.
+    void setTargetRate(double framesPerSecond);
+    [[nodiscard]] double getTargetRate() const { return targetRate; }
+
+    // Blocks until the next frame is due. A frame that started late does not make the following ones hurry.
+    void wait();
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    double targetRate = 0.0;
+    Clock::duration period{};
+    Clock::time_point next{};
+    Clock::duration spinMargin = std::chrono::milliseconds(1);
+};
+
+}  // namespace Solaris
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace Solaris {
+
+// Hands frame packets from the simulation to the renderer. A packet is whatever the renderer needs to draw one
+// frame (camera, visible objects, per-object transforms), owned by the application as an array of kSlots and
+// indexed by the slot this exchange hands out.
+//
+// The simulation writes frame N+1 into one slot while the renderer reads frame N from the other. A published
+// packet must be acquired before the next one can be written, so the renderer is never more than one frame
+// behind the simulation. Neither side touches a slot the other one holds, so packets need no locking.
+class FramePacketExchange {
+   public:
+    static constexpr uint32_t kSlots = 2;
+    static constexpr uint32_t kClosed = UINT32_MAX;
+
+    // Simulation side. Blocks until the previous packet has been acquired and returns the slot to fill, or
+    // kClosed after close().
+    [[nodiscard]] uint32_t beginWrite();
+    void publish(uint32_t slot);
+
+    // Render side. Blocks until a packet is published and returns its slot, or kClosed after close(). The slot
+    // may be reused as soon as it is released, so anything the GPU reads must be copied out first.
+    [[nodiscard]] uint32_t acquire();
+    void release(uint32_t slot);
+
+    // Wakes both sides and makes every further call return kClosed.
+    void close();
+
+   private:
+    enum class State : uint8_t { Free, Writing, Ready, Reading };
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::array<State, kSlots> states{};
+    bool closed = false;
+};
+
+template <typename T>
+using FramePackets = std::array<T, FramePacketExchange::kSlots>;
+
+}  // namespace Solaris
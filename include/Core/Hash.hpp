@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace Solaris {
+
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFnvPrime = 0x100000001b3ull;
+
+// FNV-1a, stable across runs and platforms so it can be stored on disk.
+constexpr uint64_t Fnv1a(std::span<const std::byte> bytes, uint64_t seed = kFnvOffsetBasis) {
+    uint64_t hash = seed;
+    for (auto byte : bytes) {
+        hash ^= static_cast<uint64_t>(byte);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+inline uint64_t Fnv1a(const void* data, size_t size, uint64_t seed = kFnvOffsetBasis) {
+    return Fnv1a(std::span<const std::byte>(static_cast<const std::byte*>(data), size), seed);
+}
+
+// Folds a trivially copyable value into `seed`. Only use on types without padding or pointers.
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+uint64_t HashValue(const T& value, uint64_t seed = kFnvOffsetBasis) {
+    return Fnv1a(&value, sizeof(T), seed);
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+uint64_t HashRange(std::span<T> values, uint64_t seed = kFnvOffsetBasis) {
+    seed = HashValue(values.size(), seed);
+    return Fnv1a(values.data(), values.size_bytes(), seed);
+}
+
+}  // namespace Solaris
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Solaris {
+
+// Counts outstanding jobs. A job started with a counter increments it and decrements it when done, so waiting
+// for a group of jobs is waiting for their counter to reach zero. The first exception thrown by one of the jobs is
+// kept and rethrown by JobSystem::wait().
+class JobCounter {
+   public:
+    [[nodiscard]] bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+   private:
+    friend class JobSystem;
+    std::atomic<uint32_t> pending{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+};
+
+struct WorkerStats {
+    uint64_t jobs = 0;
+    uint64_t steals = 0;
+    double busyMs = 0.0;
+    double utilization = 0.0;  // busy time over wall time since the last resetStats()
+};
+
+// Short-lived, fine grained parallel work for the frame: update, culling, command recording. Each worker owns a
+// deque; it pushes and pops its own jobs at the back and, when empty, steals from the front of the others. The
+// thread that calls init() becomes worker 0 and runs jobs whenever it waits, so waiting never blocks a core.
+//
+// Long, blocking work such as pipeline compilation or file I/O belongs on a ThreadPool instead, where it cannot
+// starve the frame.
+class JobSystem {
+   public:
+    using Job = std::move_only_function<void()>;
+
+    JobSystem() = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // workerCount == 0 uses every hardware thread, the calling thread included. When `pin` is set each worker thread
+    // is bound to one core so its deque and caches stay local; the calling thread, worker 0, is left unpinned.
+    void init(size_t workerCount = 0, bool pin = true);
+    // Runs every job still queued, then joins the workers.
+    void shutdown();
+
+    // Safe to call from any thread, including from inside a job.
+    void run(Job job, JobCounter& counter);
+    // Runs other jobs until `counter` reaches zero, then rethrows the first exception any of them threw.
+    void wait(JobCounter& counter);
+
+    // Calls fn(begin, end) over [0, count) in batches of at least `minBatch` items and returns when all are done.
+    // Rethrows the first exception of any batch, after every batch has finished.
+    void parallelFor(uint32_t count, uint32_t minBatch, const std::function<void(uint32_t begin, uint32_t end)>& fn);
+
+    [[nodiscard]] size_t size() const { return workers.size(); }
+    // Index of the calling worker, or -1 for threads outside the job system.
+    [[nodiscard]] int currentWorker() const;
+
+    [[nodiscard]] std::vector<WorkerStats> getStats() const;
+    void resetStats();
+    void logSummary() const;
+
+   private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> busyNs{0};
+    };
+
+    void workerLoop(size_t index);
+    void push(size_t worker, Job job);
+    [[nodiscard]] bool tryRunOne(size_t worker);
+    void pinCurrentThread(size_t core) const;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> nextInjection{0};
+
+    // Sleeping workers wake up when a job is pushed or on shutdown.
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<uint32_t> queued{0};
+    std::atomic<uint32_t> sleeping{0};
+    std::atomic<bool> stopping{false};
+    bool pinned = false;
+
+    std::chrono::steady_clock::time_point statsStart{};
+};
+
+}  // namespace Solaris
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace Solaris {
+
+// Read-only view of a whole file. On POSIX systems the file is mmapped, so the data is page aligned and only
+// touched pages are read; elsewhere it falls back to reading into an aligned heap buffer.
+class MappedFile {
+   public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const std::byte* data() const { return mData; }
+    [[nodiscard]] size_t size() const { return mSize; }
+    [[nodiscard]] std::span<const std::byte> bytes() const { return {mData, mSize}; }
+    [[nodiscard]] bool empty() const { return mSize == 0; }
+
+    // Hints the kernel to read the whole file ahead, for files that are consumed front to back.
+    void prefetch() const;
+
+   private:
+    void close();
+
+    const std::byte* mData = nullptr;
+    size_t mSize = 0;
+    bool mMapped = false;
+    std::vector<std::max_align_t> mFallback;
+};
+
+}  // namespace Solaris
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Solaris {
+
+struct OffsetAllocation {
+    static constexpr uint32_t kNoSpace = UINT32_MAX;
+
+    uint32_t offset = kNoSpace;
+    uint32_t node = kNoSpace;  // internal, identifies the allocation when freeing
+
+    [[nodiscard]] bool isValid() const { return offset != kNoSpace; }
+};
+
+struct OffsetAllocatorReport {
+    uint32_t totalFree = 0;
+    uint32_t largestFree = 0;
+    uint32_t freeRegions = 0;
+
+    // 0 when all free space is one region, approaching 1 as it is scattered over many small ones.
+    [[nodiscard]] float fragmentation() const {
+        return totalFree == 0 ? 0.0f : 1.0f - static_cast<float>(largestFree) / static_cast<float>(totalFree);
+    }
+};
+
+// Two-level segregated fit (TLSF) allocator over an abstract range of `size` units. It only hands out offsets, the
+// memory itself lives elsewhere, e.g. in a large GPU buffer. Allocation and freeing are O(1): free regions are
+// kept in 256 bins indexed by a small floating point encoding of their size (5 bit exponent, 3 bit mantissa) and
+// two levels of bitmasks find the first non-empty bin that fits. Freed regions are merged with free neighbors.
+//
+// Not thread safe.
+class OffsetAllocator {
+   public:
+    // `maxRegions` bounds the number of live allocations plus free regions.
+    explicit OffsetAllocator(uint32_t size = 0, uint32_t maxRegions = 128 * 1024);
+
+    void reset();
+
+    // Returns an invalid allocation when no free region is large enough.
+    [[nodiscard]] OffsetAllocation allocate(uint32_t size);
+    void free(OffsetAllocation allocation);
+
+    [[nodiscard]] uint32_t allocationSize(OffsetAllocation allocation) const;
+    [[nodiscard]] OffsetAllocatorReport report() const;
+    [[nodiscard]] uint32_t getSize() const { return size; }
+
+   private:
+    static constexpr uint32_t kTopBins = 32;
+    static constexpr uint32_t kLeafBins = 8;
+    static constexpr uint32_t kUnused = UINT32_MAX;
+
+    struct Node {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        uint32_t binPrev = kUnused;
+        uint32_t binNext = kUnused;
+        uint32_t neighborPrev = kUnused;
+        uint32_t neighborNext = kUnused;
+        bool used = false;
+    };
+
+    uint32_t insertNode(uint32_t offset, uint32_t size);
+    void removeNode(uint32_t nodeIndex);
+
+    uint32_t size = 0;
+    uint32_t maxRegions = 0;
+    uint32_t freeStorage = 0;
+    uint32_t allocations = 0;
+
+    uint32_t usedBinsTop = 0;
+    std::array<uint8_t, kTopBins> usedBins{};
+    std::array<uint32_t, kTopBins * kLeafBins> binHeads{};
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+};
+
+}  // namespace Solaris
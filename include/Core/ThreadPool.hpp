@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Solaris {
+
+// Fixed pool of worker threads for long-running, blocking background work such as pipeline compilation.
+// Short per-frame work does not belong here.
+class ThreadPool {
+   public:
+    // threadCount == 0 uses one thread per hardware thread minus one, at least one.
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        std::packaged_task<std::invoke_result_t<std::decay_t<F>>()> packaged(std::forward<F>(task));
+        auto future = packaged.get_future();
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace_back(std::move(packaged));
+        }
+        available.notify_one();
+        return future;
+    }
+
+    [[nodiscard]] size_t size() const { return workers.size(); }
+
+   private:
+    void workerLoop();
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::deque<std::move_only_function<void()>> tasks;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
+
+}  // namespace Solaris
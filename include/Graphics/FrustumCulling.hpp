@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Core/JobSystem.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Solaris::Graphics {
+
+// CPU frustum culling of object bounds, for work that has to know what is visible before anything reaches the
+// GPU: LOD selection, animation, streaming priorities.
+//
+// Bounds are kept as structure of arrays and tested eight objects at a time with AVX2, or four with SSE4.1,
+// whichever the CPU has; init() picks the widest. Every object is first tested by its bounding sphere, which
+// settles most of them from 16 bytes of memory. Only blocks with an object whose sphere straddles a plane also
+// read the AABBs, which reject the spheres' false positives along the frustum edges.
+class FrustumCuller {
+   public:
+    enum class Path : uint8_t { Scalar, Sse41, Avx2 };
+
+    [[nodiscard]] static Path getBestPath();
+    [[nodiscard]] static std::string_view getPathName(Path path);
+
+    // The best supported path unless a specific one is requested. Throws when the CPU lacks it.
+    void init();
+    void init(Path path);
+
+    [[nodiscard]] uint32_t add(const glm::vec4& sphere, const glm::vec3& boxMin, const glm::vec3& boxMax);
+    void set(uint32_t object, const glm::vec4& sphere, const glm::vec3& boxMin, const glm::vec3& boxMax);
+    void clear();
+    void reserve(uint32_t count);
+
+    // Replaces `visible` with the indices of the objects intersecting the frustum, in ascending order. `planes`
+    // point inwards, e.g. Vulkan::ExtractFrustumPlanes. With `jobs` the objects are split into chunks that are
+    // culled in parallel.
+    void cull(std::span<const glm::vec4, 6> planes, std::vector<uint32_t>& visible, JobSystem* jobs = nullptr);
+
+    [[nodiscard]] Path getPath() const { return path; }
+    [[nodiscard]] uint32_t size() const { return count; }
+
+   private:
+    // The SoA arrays, each padded to a multiple of kBlock with spheres no frustum contains.
+    struct Bounds {
+        const float* sphereX;
+        const float* sphereY;
+        const float* sphereZ;
+        const float* sphereRadius;
+        const float* boxX;
+        const float* boxY;
+        const float* boxZ;
+        const float* extentX;
+        const float* extentY;
+        const float* extentZ;
+    };
+
+    static constexpr uint32_t kBlock = 8;
+    static constexpr uint32_t kChunk = 16384;  // objects per job, a multiple of kBlock
+
+    // Culls [begin, end), both multiples of kBlock, and writes the visible indices to `out`, which has room for
+    // end - begin + kBlock. Returns how many it wrote.
+    uint32_t cullRange(const Bounds& bounds, const float* planes, uint32_t begin, uint32_t end, uint32_t* out) const;
+    [[nodiscard]] Bounds getBounds() const;
+
+    Path path = Path::Scalar;
+    uint32_t count = 0;
+
+    std::vector<float> sphereX;
+    std::vector<float> sphereY;
+    std::vector<float> sphereZ;
+    std::vector<float> sphereRadius;
+    std::vector<float> boxX;
+    std::vector<float> boxY;
+    std::vector<float> boxZ;
+    std::vector<float> extentX;
+    std::vector<float> extentY;
+    std::vector<float> extentZ;
+
+    std::vector<uint32_t> scratch;
+    std::vector<uint32_t> chunkCounts;
+};
+
+}  // namespace Solaris::Graphics
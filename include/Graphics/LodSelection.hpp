@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Core/JobSystem.hpp"
+#include "Graphics/MeshFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Solaris::Graphics {
+
+// Picks a level of detail per object every frame, the coarsest one whose simplification error projects to at most
+// Config::pixelError pixels. Objects are stored as structure of arrays and selected in one batched pass, split
+// across the job system for large scenes.
+//
+// Moving to a coarser level needs its error to be Config::hysteresis below the limit, while a level that is too
+// coarse is left at once, so an object near a threshold does not pop back and forth between two levels.
+class LodSelector {
+   public:
+    struct Config {
+        float pixelError = 1.0f;
+        float hysteresis = 0.25f;
+    };
+
+    void init(const Config& config);
+
+    // Registers the levels of detail of a mesh, e.g. MeshFile::lods() or GeometryArena::getLods(), shared by
+    // every object drawn with it. Their errors must not decrease from one level to the next.
+    [[nodiscard]] uint32_t addMesh(std::span<const MeshLod> lods);
+    // `scale` converts the mesh's object-space errors to world space. Objects start at LOD 0.
+    [[nodiscard]] uint32_t addObject(uint32_t mesh, const glm::vec3& center, float radius, float scale = 1.0f);
+    void setBounds(uint32_t object, const glm::vec3& center, float radius);
+
+    // `projectionScale` is viewportHeight / (2 tan(fovY / 2)), which turns a world-space size at distance d into
+    // projectionScale * size / d pixels. Splits the objects across `jobs` when given.
+    void select(const glm::vec3& camera, float projectionScale, JobSystem* jobs = nullptr);
+
+    [[nodiscard]] uint32_t getLod(uint32_t object) const { return lods[object]; }
+    [[nodiscard]] std::span<const uint8_t> getLods() const { return lods; }
+    // Objects whose level changed in the last select(), in ascending order; the only ones whose draws need
+    // updating, e.g. through GpuCulling::updateObjects.
+    [[nodiscard]] std::span<const uint32_t> getChanged() const { return changed; }
+    [[nodiscard]] size_t size() const { return lods.size(); }
+
+   private:
+    struct Chain {
+        std::array<float, kMaxMeshLods> errors{};
+        uint32_t count = 0;
+    };
+
+    void selectRange(uint32_t begin, uint32_t end, const glm::vec3& camera, float projectionScale);
+
+    Config config{};
+    std::vector<Chain> chains;
+
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+    std::vector<float> scale;
+    std::vector<uint32_t> chain;
+    std::vector<uint8_t> lods;
+    std::vector<uint8_t> changedFlags;
+    std::vector<uint32_t> changed;
+};
+
+}  // namespace Solaris::Graphics
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Core/MappedFile.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace Solaris::Graphics {
+
+// Binary mesh container, written offline by the meshconv tool and memory-mapped at load time. Every section
+// starts on a kMeshAlignment boundary, so the vertex and index streams are used in place: uploads copy
+// straight from the mapping into staging memory and nothing is parsed or copied on the heap.
+//
+// Layout: MeshFileHeader, then the sections it points at, in any order. All values are little-endian. A file
+// of any other version than kMeshVersion is rejected; the converter is cheap to rerun.
+inline constexpr uint32_t kMeshMagic = 0x48534d53;  // "SMSH"
+inline constexpr uint32_t kMeshVersion = 1;
+inline constexpr uint32_t kMeshAlignment = 16;
+
+enum class VertexSemantic : uint32_t { Position, Normal, Tangent, TexCoord, Color };
+
+// One vertex attribute. `format` is a VkFormat value, kept numeric so the format does not depend on Vulkan.
+struct MeshAttribute {
+    VertexSemantic semantic = VertexSemantic::Position;
+    uint32_t format = 0;
+    uint32_t stream = 0;  // index into the vertex streams
+    uint32_t offset = 0;  // within the stream's stride
+};
+
+// A vertex buffer binding: vertexCount elements of `stride` bytes, `offset` bytes into the file.
+struct MeshStream {
+    uint32_t stride = 0;
+    uint32_t reserved = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+// A level of detail, as a range of the shared index stream over the shared vertices. LOD 0 is the full mesh.
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;  // object-space deviation from LOD 0
+    uint32_t reserved = 0;
+};
+
+// Up to kMaxMeshletVertices vertices and kMaxMeshletTriangles triangles of LOD 0. The triangles index the
+// meshlet's vertex list with one byte per corner.
+struct Meshlet {
+    uint32_t vertexOffset = 0;    // into the meshlet vertex section
+    uint32_t triangleOffset = 0;  // into the meshlet triangle section, in bytes
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+    std::array<float, 3> center{};
+    float radius = 0.0f;
+};
+
+struct MeshBounds {
+    std::array<float, 3> min{};
+    std::array<float, 3> max{};
+    std::array<float, 3> center{};  // bounding sphere
+    float radius = 0.0f;
+};
+
+enum class MeshSection : uint32_t {
+    Attributes,
+    Streams,
+    Indices,
+    Lods,
+    Meshlets,
+    MeshletVertices,
+    MeshletTriangles,
+    Count,
+};
+
+struct MeshSectionRange {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+struct MeshFileHeader {
+    uint32_t magic = kMeshMagic;
+    uint32_t version = kMeshVersion;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t indexSize = 4;  // bytes per index, 1, 2 or 4
+    uint32_t reserved = 0;
+    MeshBounds bounds{};
+    std::array<MeshSectionRange, static_cast<size_t>(MeshSection::Count)> sections{};
+};
+
+static_assert(sizeof(MeshAttribute) == 16 && sizeof(MeshStream) == 24 && sizeof(MeshLod) == 16);
+static_assert(sizeof(Meshlet) == 32 && sizeof(MeshFileHeader) == 176);
+
+inline constexpr uint32_t kMaxMeshLods = 8;
+inline constexpr uint32_t kMaxMeshletVertices = 64;
+inline constexpr uint32_t kMaxMeshletTriangles = 124;
+
+// Everything a mesh file holds, in memory. What the converter fills and WriteMeshFile() stores.
+struct MeshData {
+    uint32_t vertexCount = 0;
+    uint32_t indexSize = 4;
+    MeshBounds bounds{};
+    std::vector<MeshAttribute> attributes;
+    std::vector<uint32_t> streamStrides;
+    std::vector<std::vector<std::byte>> streams;
+    std::vector<std::byte> indices;
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint8_t> meshletTriangles;
+};
+
+void WriteMeshFile(const std::filesystem::path& path, const MeshData& mesh);
+
+// A mesh file mapped into memory. Every accessor returns a view into the mapping, valid while the MeshFile
+// lives. Throws on a file that is truncated, misaligned or of another version, or whose sections point past each
+// other: streams, levels of detail and meshlets are checked against the counts in the header. Index values are
+// not checked. There is no empty state, a MeshFile always holds a validated mapping.
+class MeshFile {
+   public:
+    explicit MeshFile(const std::filesystem::path& path);
+
+    [[nodiscard]] const MeshFileHeader& header() const { return *pHeader; }
+    [[nodiscard]] uint32_t vertexCount() const { return pHeader->vertexCount; }
+    [[nodiscard]] uint32_t indexCount() const { return pHeader->indexCount; }
+    [[nodiscard]] uint32_t indexSize() const { return pHeader->indexSize; }
+    [[nodiscard]] const MeshBounds& bounds() const { return pHeader->bounds; }
+
+    [[nodiscard]] std::span<const MeshAttribute> attributes() const {
+        return section<MeshAttribute>(MeshSection::Attributes);
+    }
+    [[nodiscard]] std::span<const MeshStream> streams() const { return section<MeshStream>(MeshSection::Streams); }
+    [[nodiscard]] std::span<const MeshLod> lods() const { return section<MeshLod>(MeshSection::Lods); }
+    [[nodiscard]] std::span<const Meshlet> meshlets() const { return section<Meshlet>(MeshSection::Meshlets); }
+    [[nodiscard]] std::span<const uint32_t> meshletVertices() const {
+        return section<uint32_t>(MeshSection::MeshletVertices);
+    }
+    [[nodiscard]] std::span<const uint8_t> meshletTriangles() const {
+        return section<uint8_t>(MeshSection::MeshletTriangles);
+    }
+
+    // Raw bytes of vertex stream `stream` and of the index stream, e.g. for UploadManager::upload or for an
+    // AssetStreamer request of the same file range.
+    [[nodiscard]] std::span<const std::byte> streamBytes(uint32_t stream) const;
+    [[nodiscard]] std::span<const std::byte> indexBytes() const { return bytes(MeshSection::Indices); }
+
+    // Typed views for GeometryArena::add. Throw when V or I do not match the stream stride or index size.
+    template <typename V>
+    [[nodiscard]] std::span<const V> vertices(uint32_t stream = 0) const {
+        if (stream >= streams().size() || streams()[stream].stride != sizeof(V)) {
+            throw std::runtime_error("Vertex type does not match the mesh stream");
+        }
+        auto raw = streamBytes(stream);
+        return {reinterpret_cast<const V*>(raw.data()), raw.size() / sizeof(V)};
+    }
+    template <typename I>
+    [[nodiscard]] std::span<const I> indices() const {
+        if (indexSize() != sizeof(I)) {
+            throw std::runtime_error("Index type does not match the mesh index size");
+        }
+        auto raw = indexBytes();
+        return {reinterpret_cast<const I*>(raw.data()), raw.size() / sizeof(I)};
+    }
+
+   private:
+    [[nodiscard]] std::span<const std::byte> bytes(MeshSection section) const;
+    template <typename T>
+    [[nodiscard]] std::span<const T> section(MeshSection id) const {
+        auto raw = bytes(id);
+        return {reinterpret_cast<const T*>(raw.data()), raw.size() / sizeof(T)};
+    }
+
+    MappedFile mFile;
+    const MeshFileHeader* pHeader = nullptr;
+};
+
+}  // namespace Solaris::Graphics
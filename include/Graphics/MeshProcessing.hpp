@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Graphics/MeshFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Solaris::Graphics {
+
+// Offline mesh processing for the converter. Nothing here runs per frame.
+
+[[nodiscard]] MeshBounds ComputeBounds(std::span<const glm::vec3> positions);
+
+struct MeshletBuild {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;  // mesh vertex of each meshlet vertex
+    std::vector<uint8_t> triangles;  // three meshlet vertex indices per triangle
+};
+
+// Splits a triangle list into meshlets of at most kMaxMeshletVertices vertices and kMaxMeshletTriangles
+// triangles, in index order, so the triangle order decides how compact they are.
+[[nodiscard]] MeshletBuild BuildMeshlets(std::span<const uint32_t> indices, std::span<const glm::vec3> positions);
+
+// Post-transform vertex cache behaviour of a triangle list, simulated with a FIFO cache of `cacheSize` entries.
+// ACMR is the vertex shader invocations per triangle, 0.5 at best for a regular grid and 3 at worst; ATVR the
+// invocations per vertex, 1 at best.
+struct VertexCacheStats {
+    uint32_t misses = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+[[nodiscard]] VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices,
+                                                  uint32_t vertexCount,
+                                                  uint32_t cacheSize = 16);
+
+// New index of every old vertex, kUnusedVertex for vertices that are dropped.
+struct VertexRemap {
+    static constexpr uint32_t kUnusedVertex = UINT32_MAX;
+
+    std::vector<uint32_t> remap;
+    uint32_t vertexCount = 0;  // after remapping
+};
+
+// Merges vertices whose `stride` bytes are identical, keeping the first of each.
+[[nodiscard]] VertexRemap DeduplicateVertices(std::span<const std::byte> vertices, uint32_t stride);
+
+// Reorders triangles for the post-transform vertex cache, with Forsyth's linear-speed algorithm: triangles are
+// emitted greedily by a score favouring vertices recently used and vertices with few triangles left.
+void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount);
+
+// Orders vertices by first use in the index buffer, so the vertex fetch walks memory forward. Run after
+// OptimizeVertexCache. Vertices no triangle uses are dropped.
+[[nodiscard]] VertexRemap OptimizeVertexFetch(std::span<const uint32_t> indices, uint32_t vertexCount);
+
+void RemapIndices(std::span<uint32_t> indices, const VertexRemap& remap);
+
+struct SimplifyResult {
+    std::vector<uint32_t> indices;  // over the same vertices as the input
+    float error = 0.0f;             // object-space distance to the input surface, measured, see SimplifyMesh
+};
+
+// Collapses edges in order of their quadric error until at most `targetIndexCount` indices remain or the next
+// collapses would exceed `maxError`. The error is the largest distance of an input vertex to the result's
+// triangles around the vertex it collapsed into, a conservative stand-in for the surface deviation that is safe
+// to compare against a pixel threshold. A vertex only ever collapses onto a neighbour, never to a new position, so
+// every level of detail indexes the original vertex buffer. Vertices on a border or an attribute seam (several
+// vertices at one position) stay put, as do collapses that would flip a triangle.
+[[nodiscard]] SimplifyResult SimplifyMesh(std::span<const uint32_t> indices,
+                                          std::span<const glm::vec3> positions,
+                                          size_t targetIndexCount,
+                                          float maxError);
+
+template <typename V>
+[[nodiscard]] std::vector<V> RemapVertices(std::span<const V> vertices, const VertexRemap& remap) {
+    std::vector<V> remapped(remap.vertexCount);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        if (remap.remap[i] != VertexRemap::kUnusedVertex) {
+            remapped[remap.remap[i]] = vertices[i];
+        }
+    }
+    return remapped;
+}
+
+}  // namespace Solaris::Graphics
@@ -0,0 +1,361 @@
+#pragma once
+
+#include "Graphics/MeshFile.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Solaris::Graphics {
+
+// Vertex layouts derived at compile time from the declaration of a vertex struct. A vertex stream is a plain
+// aggregate whose members are attribute types: float, glm::vec2/3/4 or one of the packed types below. Member i
+// of stream s gets the next free location in declaration order, its format from the member type and its offset
+// from the members before it, so the pipeline, the converter and the file agree by construction:
+//
+//     struct PositionStream { Snorm16x4 position; };             // binding 0, location 0
+//     struct ShadingStream { Octahedral16 normal; Half2 uv; };    // binding 1, locations 1 and 2
+//
+//     VertexLayout<PositionStream, ShadingStream>  // full vertex
+//     VertexLayout<PositionStream>                 // depth-only passes fetch 8 bytes per vertex
+//
+// Formats are VkFormat values, kept numeric like MeshAttribute::format so this header does not need Vulkan.
+
+namespace VertexFormat {
+inline constexpr uint32_t kR8G8B8A8Unorm = 37;
+inline constexpr uint32_t kR8G8B8A8Snorm = 38;
+inline constexpr uint32_t kR16G16Snorm = 78;
+inline constexpr uint32_t kR16G16Sfloat = 83;
+inline constexpr uint32_t kR16G16B16A16Snorm = 92;
+inline constexpr uint32_t kR16G16B16A16Sfloat = 97;
+inline constexpr uint32_t kR32Uint = 98;
+inline constexpr uint32_t kR32Sfloat = 100;
+inline constexpr uint32_t kR32G32Sfloat = 103;
+inline constexpr uint32_t kR32G32B32Sfloat = 106;
+inline constexpr uint32_t kR32G32B32A32Sfloat = 109;
+}  // namespace VertexFormat
+
+// Packed attribute types. The snorm and unorm ones are expanded to floats by the vertex fetch, half floats are
+// read as floats; the shader sees the same types as with the unpacked formats.
+struct Snorm16x2 {
+    int16_t x = 0, y = 0;
+};
+struct Snorm16x4 {
+    int16_t x = 0, y = 0, z = 0, w = 0;
+};
+struct Snorm8x4 {
+    int8_t x = 0, y = 0, z = 0, w = 0;
+};
+struct Unorm8x4 {
+    uint8_t x = 0, y = 0, z = 0, w = 0;
+};
+struct Half2 {
+    uint16_t x = 0, y = 0;
+};
+struct Half4 {
+    uint16_t x = 0, y = 0, z = 0, w = 0;
+};
+// A unit vector folded onto the octahedron, see PackOctahedral. Decoded in the shader with
+//     vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+//     if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * mix(vec2(-1.0), vec2(1.0), greaterThanEqual(n.xy, vec2(0.0)));
+//     n = normalize(n);
+struct Octahedral16 {
+    int16_t x = 0, y = 0;
+};
+
+template <typename T>
+struct VertexFormatOf;
+
+template <>
+struct VertexFormatOf<float> : std::integral_constant<uint32_t, VertexFormat::kR32Sfloat> {};
+template <>
+struct VertexFormatOf<uint32_t> : std::integral_constant<uint32_t, VertexFormat::kR32Uint> {};
+template <>
+struct VertexFormatOf<glm::vec2> : std::integral_constant<uint32_t, VertexFormat::kR32G32Sfloat> {};
+template <>
+struct VertexFormatOf<glm::vec3> : std::integral_constant<uint32_t, VertexFormat::kR32G32B32Sfloat> {};
+template <>
+struct VertexFormatOf<glm::vec4> : std::integral_constant<uint32_t, VertexFormat::kR32G32B32A32Sfloat> {};
+template <>
+struct VertexFormatOf<Snorm16x2> : std::integral_constant<uint32_t, VertexFormat::kR16G16Snorm> {};
+template <>
+struct VertexFormatOf<Snorm16x4> : std::integral_constant<uint32_t, VertexFormat::kR16G16B16A16Snorm> {};
+template <>
+struct VertexFormatOf<Snorm8x4> : std::integral_constant<uint32_t, VertexFormat::kR8G8B8A8Snorm> {};
+template <>
+struct VertexFormatOf<Unorm8x4> : std::integral_constant<uint32_t, VertexFormat::kR8G8B8A8Unorm> {};
+template <>
+struct VertexFormatOf<Half2> : std::integral_constant<uint32_t, VertexFormat::kR16G16Sfloat> {};
+template <>
+struct VertexFormatOf<Half4> : std::integral_constant<uint32_t, VertexFormat::kR16G16B16A16Sfloat> {};
+template <>
+struct VertexFormatOf<Octahedral16> : std::integral_constant<uint32_t, VertexFormat::kR16G16Snorm> {};
+
+template <typename T>
+concept VertexAttributeType = requires { VertexFormatOf<T>::value; };
+
+[[nodiscard]] constexpr int16_t PackSnorm16(float value) {
+    float scaled = std::clamp(value, -1.0f, 1.0f) * 32767.0f;
+    return static_cast<int16_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+[[nodiscard]] constexpr int8_t PackSnorm8(float value) {
+    float scaled = std::clamp(value, -1.0f, 1.0f) * 127.0f;
+    return static_cast<int8_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+[[nodiscard]] constexpr uint8_t PackUnorm8(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// IEEE binary16, rounded to nearest even. Overflow goes to infinity, values below the smallest subnormal to zero.
+[[nodiscard]] constexpr uint16_t PackHalf(float value) {
+    auto bits = std::bit_cast<uint32_t>(value);
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (exponent == 0xff) {
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+    }
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1f) {
+        return static_cast<uint16_t>(sign | 0x7c00);
+    }
+
+    uint32_t half = 0;
+    uint32_t shift = 13;
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        // Subnormal, the implicit leading bit becomes explicit.
+        mantissa |= 0x800000;
+        shift = static_cast<uint32_t>(14 - halfExponent);
+    } else {
+        half = static_cast<uint32_t>(halfExponent) << 10;
+    }
+    half |= mantissa >> shift;
+    uint32_t rest = mantissa & ((1u << shift) - 1);
+    uint32_t midpoint = 1u << (shift - 1);
+    // A carry out of the mantissa correctly bumps the exponent, up to infinity.
+    if (rest > midpoint || (rest == midpoint && (half & 1) != 0)) {
+        half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+[[nodiscard]] inline Half2 PackHalf2(glm::vec2 value) {
+    return {PackHalf(value.x), PackHalf(value.y)};
+}
+
+[[nodiscard]] inline Unorm8x4 PackUnorm8x4(glm::vec4 value) {
+    return {PackUnorm8(value.x), PackUnorm8(value.y), PackUnorm8(value.z), PackUnorm8(value.w)};
+}
+
+// Maps a unit vector to the octahedron |x| + |y| + |z| = 1 and unfolds the lower half over the corners, so two
+// 16-bit components hold it with an error below 0.05 degrees.
+[[nodiscard]] inline Octahedral16 PackOctahedral(glm::vec3 n) {
+    n = n / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    glm::vec2 folded{n.x, n.y};
+    if (n.z < 0.0f) {
+        folded = {(1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                  (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)};
+    }
+    return {PackSnorm16(folded.x), PackSnorm16(folded.y)};
+}
+
+// Positions relative to the mesh bounds, dequantized in the shader with
+//     position = (min + max) / 2 + snorm * (max - min) / 2
+// which leaves a precision of 1/65534 of the mesh extent on each axis.
+[[nodiscard]] inline Snorm16x4 PackPosition(glm::vec3 position, const MeshBounds& bounds) {
+    Snorm16x4 packed{};
+    std::array<int16_t*, 3> out{&packed.x, &packed.y, &packed.z};
+    for (size_t i = 0; i < 3; i++) {
+        float center = (bounds.min[i] + bounds.max[i]) * 0.5f;
+        float extent = (bounds.max[i] - bounds.min[i]) * 0.5f;
+        *out[i] = PackSnorm16(extent > 0.0f ? (position[static_cast<int>(i)] - center) / extent : 0.0f);
+    }
+    packed.w = PackSnorm16(1.0f);
+    return packed;
+}
+
+namespace Detail {
+
+// Converts to any member type, to count the members of an aggregate by trying to brace-initialize it.
+struct AnyMember {
+    template <typename T>
+    constexpr operator T() const;  // NOLINT(google-explicit-constructor)
+};
+
+template <typename V, typename... Members>
+consteval size_t CountMembers() {
+    if constexpr (requires { V{Members{}..., AnyMember{}}; }) {
+        return CountMembers<V, Members..., AnyMember>();
+    } else {
+        return sizeof...(Members);
+    }
+}
+
+template <typename... T>
+struct TypeList {};
+
+inline constexpr size_t kMaxVertexMembers = 8;
+
+// The declared member types, in order. Only used in unevaluated contexts.
+template <typename V>
+constexpr auto MemberTypes(V& v) {
+    constexpr size_t count = CountMembers<V>();
+    static_assert(count >= 1 && count <= kMaxVertexMembers, "A vertex stream has 1 to 8 members");
+    if constexpr (count == 1) {
+        auto& [a] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>>{};
+    } else if constexpr (count == 2) {
+        auto& [a, b] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>>{};
+    } else if constexpr (count == 3) {
+        auto& [a, b, c] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>,
+                        std::remove_cvref_t<decltype(c)>>{};
+    } else if constexpr (count == 4) {
+        auto& [a, b, c, d] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>,
+                        std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>>{};
+    } else if constexpr (count == 5) {
+        auto& [a, b, c, d, e] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>,
+                        std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>,
+                        std::remove_cvref_t<decltype(e)>>{};
+    } else if constexpr (count == 6) {
+        auto& [a, b, c, d, e, f] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>,
+                        std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>,
+                        std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>>{};
+    } else if constexpr (count == 7) {
+        auto& [a, b, c, d, e, f, g] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>,
+                        std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>,
+                        std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>,
+                        std::remove_cvref_t<decltype(g)>>{};
+    } else {
+        auto& [a, b, c, d, e, f, g, h] = v;
+        return TypeList<std::remove_cvref_t<decltype(a)>, std::remove_cvref_t<decltype(b)>,
+                        std::remove_cvref_t<decltype(c)>, std::remove_cvref_t<decltype(d)>,
+                        std::remove_cvref_t<decltype(e)>, std::remove_cvref_t<decltype(f)>,
+                        std::remove_cvref_t<decltype(g)>, std::remove_cvref_t<decltype(h)>>{};
+    }
+}
+
+template <typename V, typename List = decltype(MemberTypes(std::declval<V&>()))>
+struct StreamMembers;
+
+constexpr size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Offsets follow the standard-layout rules: each member at the next multiple of its alignment, and the struct
+// padded to the largest one.
+template <typename V, typename... T>
+struct StreamMembers<V, TypeList<T...>> {
+    static_assert((VertexAttributeType<T> && ...), "Vertex stream member without a VertexFormatOf specialization");
+
+    static constexpr size_t kCount = sizeof...(T);
+    static constexpr std::array<uint32_t, kCount> kFormats{VertexFormatOf<T>::value...};
+    static constexpr std::array<uint32_t, kCount> kOffsets = [] {
+        std::array<size_t, kCount> sizes{sizeof(T)...};
+        std::array<size_t, kCount> alignments{alignof(T)...};
+        std::array<uint32_t, kCount> offsets{};
+        size_t offset = 0;
+        for (size_t i = 0; i < kCount; i++) {
+            offset = AlignUp(offset, alignments[i]);
+            offsets[i] = static_cast<uint32_t>(offset);
+            offset += sizes[i];
+        }
+        return offsets;
+    }();
+    static constexpr size_t kSize =
+        AlignUp(kOffsets[kCount - 1] + std::array<size_t, kCount>{sizeof(T)...}[kCount - 1],
+                std::max({alignof(T)...}));
+
+    static_assert(kSize == sizeof(V), "Vertex stream has members the layout cannot see, e.g. bit-fields");
+};
+
+}  // namespace Detail
+
+template <typename V>
+concept VertexStream = std::is_aggregate_v<V> && std::is_standard_layout_v<V> && !VertexAttributeType<V>;
+
+struct VertexAttributeDesc {
+    uint32_t location = 0;
+    uint32_t binding = 0;
+    uint32_t format = 0;
+    uint32_t offset = 0;
+};
+
+// The bindings and attributes of one or more vertex streams, stream i on binding i.
+template <VertexStream... Streams>
+struct VertexLayout {
+    static constexpr size_t kStreamCount = sizeof...(Streams);
+    static constexpr size_t kAttributeCount = (Detail::StreamMembers<Streams>::kCount + ...);
+
+    static constexpr std::array<uint32_t, kStreamCount> kStrides{static_cast<uint32_t>(sizeof(Streams))...};
+
+    static constexpr std::array<VertexAttributeDesc, kAttributeCount> kAttributes = [] {
+        std::array<VertexAttributeDesc, kAttributeCount> attributes{};
+        uint32_t location = 0;
+        uint32_t binding = 0;
+        auto addStream = [&]<typename S>() {
+            using Members = Detail::StreamMembers<S>;
+            for (size_t i = 0; i < Members::kCount; i++) {
+                attributes[location] = {location, binding, Members::kFormats[i], Members::kOffsets[i]};
+                location++;
+            }
+            binding++;
+        };
+        (addStream.template operator()<Streams>(), ...);
+        return attributes;
+    }();
+
+    // The attributes a converter writes for this layout, with one semantic per location.
+    [[nodiscard]] static std::vector<MeshAttribute> toMeshAttributes(
+        const std::array<VertexSemantic, kAttributeCount>& semantics) {
+        std::vector<MeshAttribute> attributes;
+        for (const auto& attribute : kAttributes) {
+            attributes.push_back(
+                {semantics[attribute.location], attribute.format, attribute.binding, attribute.offset});
+        }
+        return attributes;
+    }
+
+    // Whether a mesh file's streams can be bound as this layout: same strides, and the attributes in location
+    // order with the same formats and offsets. A layout may use a prefix of the file's streams, e.g. only the
+    // positions for a depth pass.
+    [[nodiscard]] static bool matches(std::span<const MeshStream> streams, std::span<const MeshAttribute> attributes) {
+        if (streams.size() < kStreamCount || attributes.size() < kAttributeCount) {
+            return false;
+        }
+        for (size_t i = 0; i < kStreamCount; i++) {
+            if (streams[i].stride != kStrides[i]) {
+                return false;
+            }
+        }
+        for (const auto& attribute : kAttributes) {
+            const auto& other = attributes[attribute.location];
+            if (other.stream != attribute.binding || other.format != attribute.format ||
+                other.offset != attribute.offset) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}  // namespace Solaris::Graphics
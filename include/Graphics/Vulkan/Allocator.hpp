@@ -2,23 +2,31 @@
 
 #include <vk_mem_alloc.hpp>
 #include <vk_mem_alloc_handles.hpp>
+#include <vulkan/vulkan.hpp>
 
 namespace Solaris::Graphics::Vulkan {
 
+// Usage a buffer in the relocatable pool may have, every memory type of the pool supports all of it.
+constexpr vk::BufferUsageFlags kRelocatableBufferUsage =
+    vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer |
+    vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc |
+    vk::BufferUsageFlagBits::eTransferDst;
+
 class Allocator {
    public:
     Allocator(){};
     Allocator(vma::Allocator inner) : mAllocator(inner) {}
-    ~Allocator() { mAllocator.destroy(); }
+    ~Allocator() { destroy(); }
 
     Allocator(Allocator&& rhs) noexcept { *this = std::move(rhs); }
     Allocator& operator=(Allocator&& other) noexcept {
         if (this != &other) {
-            if (mAllocator) {
-                mAllocator.destroy();
-            }
+            destroy();
             mAllocator = other.mAllocator;
+            mRelocatablePool = other.mRelocatablePool;
+            mRelocatableMemoryType = other.mRelocatableMemoryType;
             other.mAllocator = nullptr;
+            other.mRelocatablePool = nullptr;
         }
         return *this;
     }
@@ -29,8 +37,37 @@ class Allocator {
     vma::Allocator& operator*() { return mAllocator; }
     const vma::Allocator& operator*() const { return mAllocator; }
 
+    // Device-local pool holding the buffers the Defragmenter may move, and nothing else, so a defragmentation
+    // run never touches staging, ring or image memory.
+    void initRelocatablePool() {
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.setSize(1);
+        bufferInfo.setUsage(kRelocatableBufferUsage);
+        vma::AllocationCreateInfo allocInfo{};
+        allocInfo.usage = vma::MemoryUsage::eAutoPreferDevice;
+
+        vma::PoolCreateInfo poolInfo{};
+        poolInfo.memoryTypeIndex = mAllocator.findMemoryTypeIndexForBufferInfo(bufferInfo, allocInfo);
+        mRelocatablePool = mAllocator.createPool(poolInfo);
+        mRelocatableMemoryType = poolInfo.memoryTypeIndex;
+    }
+    [[nodiscard]] vma::Pool getRelocatablePool() const { return mRelocatablePool; }
+    [[nodiscard]] uint32_t getRelocatableMemoryType() const { return mRelocatableMemoryType; }
+
    private:
+    void destroy() {
+        if (mRelocatablePool) {
+            mAllocator.destroyPool(mRelocatablePool);
+            mRelocatablePool = nullptr;
+        }
+        if (mAllocator) {
+            mAllocator.destroy();
+        }
+    }
+
     vma::Allocator mAllocator{nullptr};
+    vma::Pool mRelocatablePool{nullptr};
+    uint32_t mRelocatableMemoryType = 0;
 };
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
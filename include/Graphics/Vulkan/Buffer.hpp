@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Graphics/Vulkan/Memory.hpp"
+
 #include <vk_mem_alloc.hpp>
 #include <vk_mem_alloc_enums.hpp>
 #include <vk_mem_alloc_handles.hpp>
@@ -9,8 +11,15 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <vulkan/vulkan_structs.hpp>
 
+#include <concepts>
+#include <cstdint>
+#include <vector>
+
 namespace Solaris::Graphics::Vulkan {
 
+class UploadManager;
+class Defragmenter;
+
 class Buffer {
    public:
     Buffer() = default;
@@ -24,6 +33,15 @@ class Buffer {
             _buffer = other._buffer;
             allocation = other.allocation;
             allocInfo = other.allocInfo;
+            category = other.category;
+            size = other.size;
+            usage = other.usage;
+            relocatable = other.relocatable;
+            relocating = other.relocating;
+            if (allocation) {
+                // The defragmenter finds the owner of an allocation through its user data.
+                allocator->setAllocationUserData(allocation, this);
+            }
             other._buffer = VK_NULL_HANDLE;
             other.allocation = nullptr;
         }
@@ -36,28 +54,56 @@ class Buffer {
     [[nodiscard]] vma::Allocation getAllocation() const { return allocation; }
     [[nodiscard]] const vma::AllocationInfo& getAllocationInfo() const { return allocInfo; }
     [[nodiscard]] vk::Buffer getBuffer() const { return _buffer; }
+    [[nodiscard]] MemoryCategory getCategory() const { return category; }
+
+    [[nodiscard]] bool isRelocatable() const { return relocatable; }
 
     void init(vma::Allocator* allocator,
               vk::DeviceSize size,
               vk::BufferUsageFlags usage,
               bool hostVisible = false,
-              bool deviceLocal = false);
+              bool deviceLocal = false,
+              MemoryCategory category = MemoryCategory::Other);
+    // Creates a device-local buffer in the allocator's relocatable pool, Allocator::getRelocatablePool(), which the
+    // Defragmenter may move to other memory. Its handle then changes between frames, so it must be fetched with
+    // getBuffer() when recording and never kept, e.g. in a descriptor set. `usage` must be part of
+    // kRelocatableBufferUsage.
+    void initRelocatable(vma::Allocator* allocator,
+                         vma::Pool pool,
+                         vk::DeviceSize size,
+                         vk::BufferUsageFlags usage,
+                         MemoryCategory category = MemoryCategory::Other);
 
     void* mapMemory() { return allocator->mapMemory(allocation); }
     void unmapMemory() { allocator->unmapMemory(allocation); }
+    void flush(vk::DeviceSize offset = 0, vk::DeviceSize size = VK_WHOLE_SIZE) {
+        allocator->flushAllocation(allocation, offset, size);
+    }
+    // Frees the buffer immediately. A buffer the GPU may still be using goes to the DeletionQueue instead.
     void destroy();
-    static void copy(Buffer& src,
-                     Buffer& dst,
-                     vk::DeviceSize size,
-                     vk::raii::CommandPool& commandPool,
-                     vk::raii::Device& device,
-                     vk::Queue& graphicsQueue);
 
    protected:
+    friend class Defragmenter;
+
+    void create(const vma::AllocationCreateInfo& allocCreateInfo);
+
+    // Creates a device-local buffer and queues its contents on the upload manager. The data is copied into
+    // staging memory immediately; the GPU copy happens on the next UploadManager::flush.
+    void initDeviceLocal(vma::Allocator& allocator,
+                         const void* data,
+                         vk::DeviceSize size,
+                         vk::BufferUsageFlags usage,
+                         UploadManager& uploads);
+
     vma::Allocator* allocator = nullptr;
     vk::Buffer _buffer{VK_NULL_HANDLE};
     vma::Allocation allocation{};
     vma::AllocationInfo allocInfo{};
+    MemoryCategory category = MemoryCategory::Other;
+    vk::DeviceSize size = 0;
+    vk::BufferUsageFlags usage{};
+    bool relocatable = false;
+    bool relocating = false;  // moved by the Defragmenter's current pass, the allocation belongs to VMA until it ends
 };
 
 class VertexBuffer : Buffer {
@@ -65,33 +111,10 @@ class VertexBuffer : Buffer {
     VertexBuffer() = default;
 
     template <typename V>
-    void init(vma::Allocator& _allocator,
-              const std::vector<V>& vertices,
-              vk::raii::CommandPool& commandPool,
-              vk::raii::Device& device,
-              vk::Queue& graphicsQueue) {
+    void init(vma::Allocator& _allocator, const std::vector<V>& vertices, UploadManager& uploads) {
         vk::DeviceSize bufferSize = sizeof(V) * vertices.size();
-
-        Buffer staging;
-        staging.init(&_allocator, bufferSize, vk::BufferUsageFlagBits::eTransferSrc, true);
-        auto allocInfo = staging.getAllocationInfo();
-        auto alloc = staging.getAllocation();
-
-        if (allocInfo.pMappedData) {
-            std::memcpy(allocInfo.pMappedData, vertices.data(), bufferSize);
-        } else {
-            void* data = staging.mapMemory();
-            std::memcpy(data, vertices.data(), bufferSize);
-            staging.unmapMemory();
-        }
-
-        Buffer::init(&_allocator, bufferSize,
-                     vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, false, true);
-
-        Buffer::copy(staging, *this, bufferSize, commandPool, device, graphicsQueue);
-
+        initDeviceLocal(_allocator, vertices.data(), bufferSize, vk::BufferUsageFlagBits::eVertexBuffer, uploads);
         vertexCount = static_cast<uint32_t>(vertices.size());
-        staging.destroy();
     }
 
     [[nodiscard]] size_t getVertexCount() const { return vertexCount; }
@@ -101,20 +124,44 @@ class VertexBuffer : Buffer {
     size_t vertexCount;
 };
 
+template <typename I>
+concept IndexElement = std::same_as<I, uint8_t> || std::same_as<I, uint16_t> || std::same_as<I, uint32_t>;
+
+template <IndexElement I>
+[[nodiscard]] constexpr vk::IndexType GetIndexType() {
+    if constexpr (sizeof(I) == 1) {
+        return vk::IndexType::eUint8KHR;
+    } else if constexpr (sizeof(I) == 2) {
+        return vk::IndexType::eUint16;
+    } else {
+        return vk::IndexType::eUint32;
+    }
+}
+
+[[nodiscard]] uint32_t GetIndexSize(vk::IndexType type);
+// The smallest index type that addresses `vertexCount` vertices. 8-bit indices need the device's
+// VK_KHR_index_type_uint8 support, Context::Features::indexTypeUint8.
+[[nodiscard]] vk::IndexType ChooseIndexType(uint32_t vertexCount, bool uint8Supported);
+
 class IndexBuffer : Buffer {
    public:
     IndexBuffer() = default;
-    void init(vma::Allocator& _allocator,
-              const std::vector<uint16_t>& indices,
-              vk::raii::CommandPool& commandPool,
-              vk::raii::Device& device,
-              vk::Queue& graphicsQueue);
+
+    template <IndexElement I>
+    void init(vma::Allocator& _allocator, const std::vector<I>& indices, UploadManager& uploads) {
+        vk::DeviceSize bufferSize = sizeof(I) * indices.size();
+        initDeviceLocal(_allocator, indices.data(), bufferSize, vk::BufferUsageFlagBits::eIndexBuffer, uploads);
+        indexCount = static_cast<uint32_t>(indices.size());
+        indexType = GetIndexType<I>();
+    }
 
     [[nodiscard]] size_t getIndexCount() const { return indexCount; }
+    [[nodiscard]] vk::IndexType getIndexType() const { return indexType; }
     [[nodiscard]] vk::Buffer getBuffer() const { return _buffer; }
 
    private:
     size_t indexCount;
+    vk::IndexType indexType = vk::IndexType::eUint32;
 };
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
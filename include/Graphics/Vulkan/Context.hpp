@@ -1,6 +1,20 @@
 #pragma once
+#include "Core/JobSystem.hpp"
 #include "Graphics/Vulkan/Allocator.hpp"
+#include "Graphics/Vulkan/Defragmenter.hpp"
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+#include "Graphics/Vulkan/Descriptors.hpp"
 #include "Graphics/Vulkan/Frame.hpp"
+#include "Graphics/Vulkan/Image.hpp"
+#include "Graphics/Vulkan/Memory.hpp"
+#include "Graphics/Vulkan/Pipeline.hpp"
+#include "Graphics/Vulkan/Profiler.hpp"
+#include "Graphics/Vulkan/QueueFamily.hpp"
+#include "Graphics/Vulkan/Recorder.hpp"
+#include "Graphics/Vulkan/RingBuffer.hpp"
+#include "Graphics/Vulkan/Shader.hpp"
+#include "Graphics/Vulkan/Streaming.hpp"
+#include "Graphics/Vulkan/Upload.hpp"
 
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
@@ -20,38 +34,127 @@ struct Context {
     vk::raii::Device device{nullptr};
     vk::Queue graphicsQueue{nullptr};
     vk::Queue presentQueue{nullptr};
+    vk::Queue transferQueue{nullptr};  // graphics queue when there is no dedicated transfer family
+    QueueFamilyIndices queueFamilies{};
     Allocator allocator;
+    // Per-heap budgets and per-category usage, sampled every frame
+    MemoryTracker memory;
+    // Resources dropped while frames may still use them; declared early so it is destroyed after its users
+    DeletionQueue deletionQueue;
+
+    // Optional device features, negotiated in initCore
+    struct Features {
+        bool pipelineStatisticsQuery = false;
+        bool descriptorIndexing = false;  // everything BindlessDescriptors needs
+        bool drawIndirectCount = false;
+        bool multiDrawIndirect = false;
+        bool drawIndirectFirstInstance = false;
+        bool shaderDrawParameters = false;  // gl_DrawID
+        bool presentWait = false;  // VK_KHR_present_id and VK_KHR_present_wait
+        bool memoryBudget = false;  // VK_EXT_memory_budget
+        bool indexTypeUint8 = false;  // VK_KHR_index_type_uint8
+    } features;
 
     // Swapchain + Swapchain resources
     vk::raii::SwapchainKHR swapchain{nullptr};
+    vk::PresentModeKHR requestedPresentMode = vk::PresentModeKHR::eMailbox;  // set before init
+    vk::PresentModeKHR presentMode{};
+    uint64_t presentId = 0;  // id of the last present, when features.presentWait
     vk::Format swapchainFormat{};
     vk::Extent2D swapchainExtent{};
     std::vector<vk::Image> swapchainImages{};
     std::vector<vk::raii::ImageView> swapchainViews{};
     std::vector<vk::raii::Framebuffer> swapchainFramebuffers{};
+    // One per swapchain image: signaled by the frame that rendered into the image, waited on by its present.
+    // Per image rather than per frame, since an image's present may still be pending when its frame slot is reused.
+    std::vector<vk::raii::Semaphore> presentSemaphores{};
+    // Present semaphores of replaced swapchains. The frame timeline does not cover the present engine's wait on
+    // them, so they are only handed to the deletion queue once an image of the new swapchain has been acquired.
+    std::vector<vk::raii::Semaphore> retiredPresentSemaphores{};
+
+    // Headless: offscreen images standing in for the swapchain
+    bool headless = false;
+    std::vector<Image> offscreenImages{};
+    uint32_t offscreenImageIndex = 0;
 
     // Render pass
     vk::raii::RenderPass renderPass{nullptr};
 
+    // Bindless descriptor set and the pipeline layout shared by every pipeline
+    BindlessDescriptors descriptors;
+
+    // Shader modules, declared before the pipelines that are compiled from them
+    ShaderRegistry shaders;
+
+    // Pipelines
+    PipelineRegistry pipelines;
+
     // Command Pool
     vk::raii::CommandPool commandPool{nullptr};
 
     // Frames
     Frames frames;
 
+    // Secondary command buffers recorded as jobs
+    ParallelRecorder recorder;
+
+    // Owned by the application, set before init
+    JobSystem* jobs = nullptr;
+
+    // Profiling
+    GpuProfiler profiler;
+
+    // Uploads
+    UploadManager uploads;
+
+    // File contents streamed into device buffers from a background I/O thread
+    AssetStreamer streamer;
+
+    // Per-frame transient vertex, index and uniform data
+    FrameRingBuffer transientBuffer;
+
+    // Moves relocatable buffers out of fragmented device memory, a few per frame
+    Defragmenter defragmenter;
+
 #if defined(NDEBUG)
     bool validationEnabled = false;
 #else
     bool validationEnabled = true;
 #endif
     // API
-    void init(GLFWwindow* window);
-    void initCore(GLFWwindow* window);
+    void init(GLFWwindow* window, size_t framesInFlight = 2);
+    // Frames in flight are clamped to the image count, the frame wait is what guards an offscreen image's reuse.
+    void initHeadless(vk::Extent2D extent, uint32_t imageCount, size_t framesInFlight = 2);
+    void initCore(GLFWwindow* window);  // window == nullptr selects headless mode
     void initSwapchain(GLFWwindow* window, const vk::raii::SwapchainKHR& oldSwapchain = {nullptr});
-    void initSwapchainResources();         // views, framebuffers
+    void initOffscreen(vk::Extent2D extent, uint32_t imageCount);
+    void initRenderPass(vk::ImageLayout finalLayout);
+    void initSwapchainResources();         // views, framebuffers, present semaphores
     void initCommands(size_t frameCount);  // command pool
+    void initRecorder();
+    void initUploads();
+    void initDescriptors();
+    void initShaders(const std::filesystem::path& directory);
+    void initPipelines(const std::filesystem::path& cachePath);
+    void initTransientBuffer(vk::DeviceSize frameSize);
+    void initProfiler(bool pipelineStatistics);
+    void initDefragmenter(const Defragmenter::Config& config = {});
+    void initStreamer(const AssetStreamer::Config& config = {});
+    // Per-frame housekeeping once the current frame slot has been waited on: retires finished uploads, submits this
+    // frame's share of streamed data, recycles the frame's transient memory and recording pools, releases whatever
+    // the deletion queue holds for completed frames, samples the memory budgets and swaps in pipelines rebuilt
+    // after shader changes.
+    void beginFrame();
+    // Low latency pacing: blocks until the last presented frame has reached the display, or without present wait
+    // until the GPU has finished it, so that input sampled afterwards is as fresh as possible.
+    void waitForLastPresent();
+    // Builds a new swapchain from the current one without waiting for the GPU. The old one keeps presenting what
+    // was already queued and goes to the deletion queue with its views and framebuffers. The render pass and its
+    // format are kept; throws if the surface no longer supports that format.
     void recreateSwapchain(GLFWwindow* window);
-    void destroySwapchainResources();
+    // Call after every successful acquire, releases the present semaphores of replaced swapchains.
+    void onImageAcquired();
+    [[nodiscard]] uint32_t acquireOffscreenImage();
 };
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
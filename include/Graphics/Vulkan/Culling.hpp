@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/RingBuffer.hpp"
+
+#include <glm/glm.hpp>
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+class ShaderRegistry;
+class UploadManager;
+
+// Per-object record read by shaders/cull.comp, laid out for std430.
+struct GpuObject {
+    glm::vec4 sphere{0.0f};  // bounding sphere: xyz center, w radius
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t vertexOffset = 0;
+    uint32_t transformIndex = 0;  // the draw's firstInstance, see GpuCulling
+    uint32_t batch = 0;
+    uint32_t pad[3]{};
+};
+static_assert(sizeof(GpuObject) == 48);
+
+// Objects drawn with one pipeline. Their records are contiguous in the object buffer.
+struct DrawBatch {
+    uint32_t firstObject = 0;
+    uint32_t objectCount = 0;
+};
+
+using FrustumPlanes = std::array<glm::vec4, 6>;
+
+// Normalized planes of a Vulkan (zero to one depth) view-projection matrix, pointing inwards.
+[[nodiscard]] FrustumPlanes ExtractFrustumPlanes(const glm::mat4& viewProjection);
+
+// GPU-driven draw submission. Object records live in a device-local storage buffer; every frame a compute pass
+// frustum-culls them and writes compacted VkDrawIndexedIndirectCommands plus one draw count per batch, which are
+// then consumed by a single drawIndexedIndirectCount per batch. The CPU work per frame is a dispatch and one draw
+// call per batch regardless of the object count.
+//
+// Without drawIndirectCount the commands are not compacted: every object keeps its slot and culled objects are
+// written with zero instances.
+//
+// Vertex shaders find the object's transform index in gl_InstanceIndex. Without drawIndirectFirstInstance every
+// firstInstance is zero instead, and the index is read from getDrawTransforms() at the batch's firstObject +
+// gl_DrawID (shaderDrawParameters), which needs drawIndirectCount or multiDrawIndirect so a batch is one draw call.
+class GpuCulling {
+   public:
+    void init(const vk::raii::Device& device,
+              vma::Allocator* allocator,
+              ShaderRegistry& shaders,
+              const vk::raii::PipelineCache& cache,
+              size_t framesInFlight,
+              uint32_t maxObjects,
+              uint32_t maxBatches,
+              bool drawIndirectCount,
+              bool multiDrawIndirect,
+              bool drawIndirectFirstInstance);
+
+    // Replaces every object and batch. Goes through the upload manager, so only call while no frame in flight
+    // is reading the buffers, e.g. while loading.
+    void setObjects(std::span<const GpuObject> objects, std::span<const DrawBatch> batches, UploadManager& uploads);
+    // Overwrites objects starting at `first`. The data is staged in the frame's ring buffer and copied at the
+    // start of the next cull(), so it is safe to call every frame.
+    void updateObjects(uint32_t first, std::span<const GpuObject> objects, FrameRingBuffer& ring);
+
+    // Records the culling dispatch. Call outside a render pass, before any draw().
+    void cull(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, const FrustumPlanes& planes);
+    // Draws the visible objects of `batch` with whatever pipeline and vertex/index buffers are bound.
+    void draw(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, uint32_t batch) const;
+
+    // One uint32_t transform index per draw slot, written by cull() for frame `frameIndex`.
+    [[nodiscard]] vk::Buffer getDrawTransforms(uint32_t frameIndex) const {
+        return frames[frameIndex].transforms.getBuffer();
+    }
+    [[nodiscard]] bool hasFirstInstance() const { return firstInstance; }
+    [[nodiscard]] uint32_t getObjectCount() const { return objectCount; }
+    [[nodiscard]] uint32_t getBatchCount() const { return static_cast<uint32_t>(batches.size()); }
+
+   private:
+    struct FrameResources {
+        Buffer draws;
+        Buffer counts;
+        Buffer transforms;
+        vk::raii::DescriptorSet set{nullptr};
+    };
+
+    const vk::raii::Device* device = nullptr;
+    vma::Allocator* allocator = nullptr;
+
+    vk::raii::DescriptorSetLayout setLayout{nullptr};
+    vk::raii::DescriptorPool pool{nullptr};
+    vk::raii::PipelineLayout pipelineLayout{nullptr};
+    vk::raii::Pipeline pipeline{nullptr};
+
+    Buffer objectBuffer;
+    Buffer batchBuffer;
+    std::vector<FrameResources> frames;
+
+    std::vector<DrawBatch> batches;
+    std::vector<vk::BufferCopy> pendingCopies;
+    vk::Buffer pendingSource{VK_NULL_HANDLE};
+
+    uint32_t maxObjects = 0;
+    uint32_t maxBatches = 0;
+    uint32_t objectCount = 0;
+    bool compact = false;
+    bool multiDraw = false;
+    bool firstInstance = false;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
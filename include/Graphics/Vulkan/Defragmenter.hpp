@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+class Allocator;
+class Frames;
+class UploadManager;
+
+// Incremental defragmentation of the allocator's relocatable pool with VMA's defragmentation API. Once enough of
+// the pool's memory type is unused in scattered free ranges, rather than in one large range such as the tail of a
+// block, a run starts and moves a bounded number of allocations per frame. Each move creates a new buffer in the
+// destination memory and records a GPU copy at the start of the frame; the moved Buffer switches to the new handle
+// right away, so everything recorded after the copy reads the new location. The pass ends, and VMA releases the
+// source memory, once that frame has completed.
+//
+// Only buffers created with Buffer::initRelocatable live in the pool, everything else is never part of a run.
+class Defragmenter {
+   public:
+    struct Config {
+        vk::DeviceSize maxBytesPerPass = 16 * 1024 * 1024;
+        uint32_t maxMovesPerPass = 64;
+        float fragmentationThreshold = 0.25f;  // unused share outside the largest free range that starts a run
+        vk::DeviceSize minReclaimable = 16 * 1024 * 1024;  // and the least such space worth a run
+        uint32_t cooldownFrames = 300;  // frames between the end of a run, or a check that found none, and the next
+    };
+
+    Defragmenter() = default;
+    ~Defragmenter();
+
+    Defragmenter(const Defragmenter&) = delete;
+    Defragmenter& operator=(const Defragmenter&) = delete;
+
+    void init(Allocator& allocator,
+              const vk::raii::Device& device,
+              const Frames& frames,
+              UploadManager& uploads,
+              const Config& config);
+
+    // Called once per frame at the start of the frame's command buffer, outside a render pass. Ends the pass
+    // whose copies have completed and records the moves of the next one.
+    void update(const vk::raii::CommandBuffer& cmd);
+
+    // Ends the current run once the device is idle, while every moved buffer is still alive. Call before the
+    // owners of relocatable buffers are destroyed; without it the destructor can only abandon the run.
+    void shutdown();
+
+    [[nodiscard]] bool isRunning() const { return context != nullptr; }
+    // Totals over every finished run.
+    [[nodiscard]] const vma::DefragmentationStats& getTotals() const { return totals; }
+    void logSummary() const;
+
+   private:
+    [[nodiscard]] bool shouldStart() const;
+    void beginPass(const vk::raii::CommandBuffer& cmd);
+    void endPass();
+    void finish();
+
+    vma::Allocator* allocator = nullptr;
+    vma::Pool pool{nullptr};
+    uint32_t memoryTypeIndex = 0;  // the pool's
+    const vk::raii::Device* device = nullptr;
+    const Frames* frames = nullptr;
+    UploadManager* uploads = nullptr;
+    Config config{};
+
+    vma::DefragmentationContext context{nullptr};
+    vma::DefragmentationPassMoveInfo pass{};
+    bool passPending = false;
+    uint64_t passValue = 0;            // frame timeline value that completes the pass's copies
+    std::vector<vk::Buffer> replaced;  // handles the pass's buffers had before their move
+    uint64_t nextCheck = 0;            // frame timeline value before which no run starts
+
+    vma::DefragmentationStats totals{};
+    uint32_t runs = 0;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
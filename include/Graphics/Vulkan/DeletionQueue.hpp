@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+class Frames;
+
+// Defers destroying GPU resources until no frame can still use them. Everything handed over while a frame is
+// being built is tagged with the frame timeline value that frame's submission will signal, and collect()
+// releases it once the GPU has reached that value. Resources can then be dropped mid-frame without waiting for
+// the device to go idle.
+//
+// Safe to use from any thread. collect() belongs to the frame loop.
+class DeletionQueue {
+   public:
+    DeletionQueue() = default;
+    ~DeletionQueue();
+
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+    void init(const Frames& frames);
+
+    // Keeps `resource` alive until the frames that may reference it have completed, then destroys it. Works for
+    // anything movable that releases itself in its destructor: RAII handles, Buffer, Image, or a struct of them.
+    template <typename T>
+    void retire(T&& resource) {
+        defer([resource = std::forward<T>(resource)] {});
+    }
+    // Runs `callback` once the frames submitted so far have completed, e.g. to return a slot to a free list.
+    // Callbacks still pending at shutdown are dropped without running.
+    void defer(std::move_only_function<void()> callback);
+
+    // Called once per frame after the frame slot has been waited on.
+    void collect(uint64_t completedValue);
+    // Runs and releases everything. Only when the device is idle; Application calls it on shutdown, before
+    // onShutdown() destroys what the callbacks may refer to.
+    void flush();
+
+    [[nodiscard]] size_t size() const;
+
+   private:
+    struct Entry {
+        uint64_t value;
+        std::move_only_function<void()> callback;
+    };
+
+    const Frames* frames = nullptr;
+    mutable std::mutex mutex;
+    std::deque<Entry> entries;  // ordered by value
+};
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+// Index of a resource in the bindless set, passed to shaders through push constants.
+using BindlessIndex = uint32_t;
+constexpr BindlessIndex kInvalidBindlessIndex = UINT32_MAX;
+
+// One large descriptor set shared by every pipeline, holding all storage buffers, sampled images and samplers in
+// separate arrays:
+//
+//   set 0, binding 0: buffer  storageBuffers[]
+//   set 0, binding 1: texture2D sampledImages[]
+//   set 0, binding 2: sampler samplers[]
+//
+// Resources are written once when registered and addressed by index afterwards, so the set is bound once per
+// command buffer instead of per draw. The set is created with update-after-bind, which lets resources be
+// registered while earlier frames using the set are still executing.
+//
+// Requires descriptor indexing. Without it the registry only provides the shared pipeline layout with its push
+// constant range, and registering resources throws.
+class BindlessDescriptors {
+   public:
+    static constexpr uint32_t kStorageBufferBinding = 0;
+    static constexpr uint32_t kSampledImageBinding = 1;
+    static constexpr uint32_t kSamplerBinding = 2;
+    // The minimum every implementation guarantees.
+    static constexpr uint32_t kPushConstantSize = 128;
+
+    struct Capacity {
+        uint32_t storageBuffers = 65536;
+        uint32_t sampledImages = 65536;
+        uint32_t samplers = 1024;
+    };
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              bool supported,
+              DeletionQueue& deletionQueue,
+              Capacity capacity = {});
+
+    // Registering is safe from any thread. The returned index is valid until released.
+    [[nodiscard]] BindlessIndex registerBuffer(vk::Buffer buffer,
+                                               vk::DeviceSize offset = 0,
+                                               vk::DeviceSize range = VK_WHOLE_SIZE);
+    [[nodiscard]] BindlessIndex registerImage(vk::ImageView view,
+                                              vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal);
+    [[nodiscard]] BindlessIndex registerSampler(vk::Sampler sampler);
+
+    // The slot is reused only once every frame that could still read it has completed.
+    void releaseBuffer(BindlessIndex index);
+    void releaseImage(BindlessIndex index);
+    void releaseSampler(BindlessIndex index);
+
+    // Binds the set to set 0 of the shared layout. Does nothing when bindless is unavailable.
+    void bind(const vk::raii::CommandBuffer& cmd, vk::PipelineBindPoint bindPoint) const;
+
+    template <typename T>
+    void pushConstants(const vk::raii::CommandBuffer& cmd, const T& constants, uint32_t offset = 0) const {
+        static_assert(sizeof(T) <= kPushConstantSize, "push constants exceed the guaranteed 128 bytes");
+        cmd.pushConstants<T>(*pipelineLayout, vk::ShaderStageFlagBits::eAll, offset, constants);
+    }
+
+    [[nodiscard]] bool isEnabled() const { return enabled; }
+    [[nodiscard]] vk::DescriptorSetLayout getSetLayout() const { return *setLayout; }
+    [[nodiscard]] vk::DescriptorSet getSet() const { return *set; }
+    // Layout for every pipeline using bindless resources: the bindless set plus the push constant range.
+    [[nodiscard]] vk::PipelineLayout getPipelineLayout() const { return *pipelineLayout; }
+
+   private:
+    // Free list of array slots for one binding. Released slots return to it through the deletion queue.
+    struct Slots {
+        uint32_t capacity = 0;
+        uint32_t next = 0;
+        std::vector<uint32_t> free;
+    };
+
+    [[nodiscard]] uint32_t allocate(Slots& slots, const char* kind);
+    void release(Slots& slots, uint32_t index);
+
+    const vk::raii::Device* device = nullptr;
+    DeletionQueue* deletionQueue = nullptr;
+    bool enabled = false;
+
+    vk::raii::DescriptorPool pool{nullptr};
+    vk::raii::DescriptorSetLayout setLayout{nullptr};
+    vk::raii::DescriptorSet set{nullptr};
+    vk::raii::PipelineLayout pipelineLayout{nullptr};
+
+    std::mutex mutex;
+    Slots buffers;
+    Slots images;
+    Slots samplers;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -4,28 +4,48 @@
 #include <vulkan/vulkan_handles.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
 namespace Solaris::Graphics::Vulkan {
 
 struct Frame {
     vk::raii::CommandBuffer commandBuffer{nullptr};
     vk::raii::Semaphore imageAvailableSemaphore{nullptr};
-    vk::raii::Semaphore renderFinishedSemaphore{nullptr};
-    vk::raii::Fence inFlightFence{nullptr};
+    uint64_t submitValue = 0;  // frame timeline value signaled by this frame's last submission
 
     void init(vk::raii::Device& device);
 };
 
+// Per-frame resources for a fixed number of frames in flight, independent of the swapchain image count. The GPU
+// signals one timeline semaphore with an increasing value per submitted frame, so waiting for a frame slot is a
+// wait for that slot's last value instead of a per-frame fence.
 class Frames {
    public:
     void init(vk::raii::Device& device, size_t frameCount);
 
     [[nodiscard]] Frame& getCurrentFrame() { return frames[currentFrame]; }
+    [[nodiscard]] uint32_t getCurrentIndex() const { return currentFrame; }
     void updateFrame() { currentFrame = (currentFrame + 1) % frames.size(); }
     [[nodiscard]] std::vector<Frame>& getAll() { return frames; }
 
+    // Blocks until the GPU has finished the last submission of the current frame slot.
+    void waitCurrent(const vk::raii::Device& device) const { wait(device, frames[currentFrame].submitValue); }
+    void wait(const vk::raii::Device& device, uint64_t value) const;
+    // Returns the timeline value the current frame's submission must signal and records it for waitCurrent().
+    [[nodiscard]] uint64_t nextSignalValue();
+
+    [[nodiscard]] vk::Semaphore getTimeline() const { return *timeline; }
+    [[nodiscard]] uint64_t getCompletedValue() const { return timeline.getCounterValue(); }
+    // Safe to call from any thread.
+    [[nodiscard]] uint64_t getSubmittedValue() const { return submitted.load(std::memory_order_acquire); }
+
    private:
     uint32_t currentFrame = 0;
     std::vector<Frame> frames;
+    vk::raii::Semaphore timeline{nullptr};
+    std::atomic<uint64_t> submitted{0};
 };
 
-}  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Core/OffsetAllocator.hpp"
+#include "Graphics/MeshFile.hpp"
+#include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+class UploadManager;
+
+struct MeshHandle {
+    static constexpr uint32_t kInvalid = UINT32_MAX;
+    uint32_t id = kInvalid;
+
+    [[nodiscard]] bool isValid() const { return id != kInvalid; }
+};
+
+// Where a mesh lives in the arena, in the terms vkCmdDrawIndexed takes.
+struct MeshRange {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t vertexOffset = 0;
+};
+
+// Shared vertex and index buffers for every mesh of one vertex format. Meshes are suballocated with an
+// OffsetAllocator, so adding and removing one is O(1), and all of them draw after a single bind of the buffers
+// with the MeshRange as arguments.
+//
+// A format of several streams, e.g. VertexLayout<PositionStream, ShadingStream>, gets one vertex buffer per stream,
+// bound to bindings 0, 1, ... in order. Every stream holds a mesh's vertices at the same offset, so one MeshRange
+// addresses all of them, and a pass that only reads the first streams binds just those.
+//
+// Freed ranges come back through the deletion queue once the frames that could still read them have completed,
+// so the arena must not be destroyed while the frame loop is still running. When the free space is fragmented
+// past a threshold, update() packs the live meshes into fresh buffers on the GPU. That changes every MeshRange,
+// which is signaled by getGeneration() changing.
+class GeometryArena {
+   public:
+    struct Config {
+        std::vector<uint32_t> vertexStrides;  // one per stream, e.g. VertexLayout::kStrides
+        uint32_t vertexCapacity = 1 << 20;
+        uint32_t indexCapacity = 1 << 22;
+        // Indices are relative to each mesh's vertexOffset, so the type only has to address the largest mesh, not
+        // the whole arena. See ChooseIndexType.
+        vk::IndexType indexType = vk::IndexType::eUint32;
+        float compactionThreshold = 0.5f;  // fragmentation of either buffer that triggers compaction
+    };
+
+    // Both buffers are created in `pool`, the allocator's relocatable pool.
+    void init(vma::Allocator* allocator,
+              vma::Pool pool,
+              UploadManager& uploads,
+              DeletionQueue& deletionQueue,
+              const Config& config);
+
+    // Uploads a mesh through the upload manager. Indices of another width than the arena's are converted, which
+    // throws when one does not fit. Throws on a mesh without vertices or indices, and when the arena has no free
+    // range large enough.
+    //
+    // `lods` are ranges of `indices`, e.g. MeshFile::lods(), all sharing the vertices; without them the whole
+    // index range is the only level of detail.
+    template <typename V, IndexElement I>
+    [[nodiscard]] MeshHandle add(std::span<const V> vertices,
+                                 std::span<const I> indices,
+                                 std::span<const MeshLod> lods = {}) {
+        if (config.vertexStrides.size() != 1 || sizeof(V) != config.vertexStrides[0]) {
+            throw std::runtime_error("Mesh does not match the arena's vertex format");
+        }
+        const void* streams[] = {vertices.data()};
+        if (sizeof(I) != indexSize) {
+            std::vector<uint32_t> converted(indices.begin(), indices.end());
+            return addConverted(streams, static_cast<uint32_t>(vertices.size()), converted, lods);
+        }
+        return add(streams, static_cast<uint32_t>(vertices.size()), indices.data(),
+                   static_cast<uint32_t>(indices.size()), lods);
+    }
+    // Every stream of the file, straight from the mapping, with its levels of detail. The file's streams must
+    // match the arena's strides.
+    [[nodiscard]] MeshHandle add(const MeshFile& mesh);
+    void remove(MeshHandle mesh);
+
+    // Level of detail `lod` of the mesh, the coarsest one past the last.
+    [[nodiscard]] MeshRange getRange(MeshHandle mesh, uint32_t lod = 0) const;
+    [[nodiscard]] std::span<const MeshLod> getLods(MeshHandle mesh) const;
+
+    // Called once per frame, outside a render pass and before any draw from the arena. Records a compaction into
+    // `cmd` when the arena is too fragmented.
+    void update(const vk::raii::CommandBuffer& cmd);
+
+    // Binds the first `streamCount` vertex streams, all of them by default, and the index buffer.
+    void bind(const vk::raii::CommandBuffer& cmd, uint32_t streamCount = UINT32_MAX) const;
+    void draw(const vk::raii::CommandBuffer& cmd, MeshHandle mesh, uint32_t instanceCount = 1) const;
+
+    // The defragmenter may move the buffers between frames, so fetch the handles when recording.
+    [[nodiscard]] vk::Buffer getVertexBuffer(uint32_t stream = 0) const { return vertexBuffers[stream].getBuffer(); }
+    [[nodiscard]] uint32_t getStreamCount() const { return static_cast<uint32_t>(vertexBuffers.size()); }
+    [[nodiscard]] vk::Buffer getIndexBuffer() const { return indexBuffer.getBuffer(); }
+    [[nodiscard]] vk::IndexType getIndexType() const { return config.indexType; }
+    [[nodiscard]] uint64_t getGeneration() const { return generation; }
+    [[nodiscard]] float getFragmentation() const;
+
+   private:
+    struct Mesh {
+        OffsetAllocation vertices;
+        OffsetAllocation indices;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        bool alive = false;
+        std::array<MeshLod, kMaxMeshLods> lods{};  // relative to the mesh's first index
+        uint32_t lodCount = 0;
+    };
+
+    // One pointer per stream.
+    [[nodiscard]] MeshHandle add(std::span<const void* const> streams,
+                                 uint32_t vertexCount,
+                                 const void* indices,
+                                 uint32_t indexCount,
+                                 std::span<const MeshLod> lods);
+    [[nodiscard]] MeshHandle addConverted(std::span<const void* const> streams,
+                                          uint32_t vertexCount,
+                                          std::span<const uint32_t> indices,
+                                          std::span<const MeshLod> lods);
+    void compact(const vk::raii::CommandBuffer& cmd);
+    void createBuffers(std::vector<Buffer>& vertices, Buffer& indices) const;
+
+    vma::Allocator* allocator = nullptr;
+    vma::Pool pool{nullptr};
+    UploadManager* uploads = nullptr;
+    DeletionQueue* deletionQueue = nullptr;
+    Config config{};
+    uint32_t indexSize = 4;
+
+    std::vector<Buffer> vertexBuffers;  // one per stream
+    Buffer indexBuffer;
+    OffsetAllocator vertexRanges;
+    OffsetAllocator indexRanges;
+
+    std::vector<Mesh> meshes;
+    std::vector<uint32_t> freeIds;
+    // Ranges waiting in the deletion queue. They belong to the current allocators, so no compaction until
+    // they are back.
+    uint32_t pendingFrees = 0;
+    uint64_t generation = 0;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Graphics/Vulkan/Memory.hpp"
+
+#include <vk_mem_alloc.hpp>
+#include <vk_mem_alloc_enums.hpp>
+#include <vk_mem_alloc_handles.hpp>
+#include <vk_mem_alloc_structs.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_structs.hpp>
+
+namespace Solaris::Graphics::Vulkan {
+
+class Image {
+   public:
+    Image() = default;
+    ~Image() { destroy(); }
+
+    Image(Image&& other) noexcept { *this = std::move(other); }
+    Image& operator=(Image&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            allocator = other.allocator;
+            _image = other._image;
+            allocation = other.allocation;
+            format = other.format;
+            extent = other.extent;
+            category = other.category;
+            size = other.size;
+            other._image = VK_NULL_HANDLE;
+            other.allocation = nullptr;
+        }
+        return *this;
+    }
+
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+
+    [[nodiscard]] vk::Image getImage() const { return _image; }
+    [[nodiscard]] vk::Format getFormat() const { return format; }
+    [[nodiscard]] vk::Extent2D getExtent() const { return extent; }
+    [[nodiscard]] vma::Allocation getAllocation() const { return allocation; }
+
+    void init(vma::Allocator* allocator,
+              vk::Extent2D extent,
+              vk::Format format,
+              vk::ImageUsageFlags usage,
+              MemoryCategory category = MemoryCategory::Textures);
+    void destroy();
+
+   private:
+    vma::Allocator* allocator = nullptr;
+    vk::Image _image{VK_NULL_HANDLE};
+    vma::Allocation allocation{};
+    vk::Format format{};
+    vk::Extent2D extent{};
+    MemoryCategory category = MemoryCategory::Textures;
+    vk::DeviceSize size = 0;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
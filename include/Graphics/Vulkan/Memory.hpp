@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+// What an allocation is for. Buffers and images are tagged at creation, which gives the memory report its
+// breakdown and names the allocations in the VMA JSON dump.
+enum class MemoryCategory : uint8_t { Geometry, Staging, PerFrame, Textures, RenderTargets, Other };
+inline constexpr size_t kMemoryCategoryCount = 6;
+
+[[nodiscard]] std::string_view getCategoryName(MemoryCategory category);
+
+// Called by Buffer and Image for every allocation they make and free. The totals are process-wide.
+void trackAllocation(const vma::Allocator& allocator,
+                     vma::Allocation allocation,
+                     MemoryCategory category,
+                     vk::DeviceSize size);
+void untrackAllocation(MemoryCategory category, vk::DeviceSize size);
+
+struct HeapReport {
+    vk::DeviceSize usage = 0;   // whole process, driver estimate with VK_EXT_memory_budget
+    vk::DeviceSize budget = 0;  // what the process can use before the driver starts paging
+    vk::DeviceSize blockBytes = 0;
+    vk::DeviceSize allocationBytes = 0;
+    uint32_t blockCount = 0;
+    uint32_t allocationCount = 0;
+    bool deviceLocal = false;
+
+    [[nodiscard]] float getPressure() const;
+    // Share of the allocated blocks that holds no allocation.
+    [[nodiscard]] float getFragmentation() const;
+};
+
+struct CategoryReport {
+    vk::DeviceSize bytes = 0;
+    uint32_t allocationCount = 0;
+};
+
+struct MemoryReport {
+    std::vector<HeapReport> heaps;
+    std::array<CategoryReport, kMemoryCategoryCount> categories{};
+
+    [[nodiscard]] const CategoryReport& get(MemoryCategory category) const {
+        return categories[static_cast<size_t>(category)];
+    }
+};
+
+// Samples VMA's heap budgets once per frame. When a heap's usage crosses `threshold` of its budget, the budget
+// callback runs on every update until usage is back under it, so that streaming can evict before the driver
+// starts paging.
+class MemoryTracker {
+   public:
+    // The heap over budget and the report that found it.
+    using BudgetCallback = std::function<void(uint32_t heap, const MemoryReport& report)>;
+
+    void init(const vma::Allocator& allocator, const vk::raii::PhysicalDevice& physicalDevice, bool memoryBudget);
+
+    void setBudgetCallback(float threshold, BudgetCallback callback);
+
+    // Called once per frame from Context::beginFrame.
+    void update();
+
+    [[nodiscard]] const MemoryReport& getReport() const { return report; }
+    [[nodiscard]] const HeapReport& getPeak(uint32_t heap) const { return peaks[heap]; }
+
+    // Writes VMA's statistics string, with every allocation and its category, as JSON.
+    void dumpJson(const std::filesystem::path& path) const;
+    void logSummary() const;
+
+   private:
+    const vma::Allocator* allocator = nullptr;
+    bool budgetExtension = false;
+    uint64_t frame = 0;
+    std::vector<vk::MemoryHeapFlags> heapFlags;
+
+    MemoryReport report{};
+    std::vector<HeapReport> peaks;  // report of each heap at its highest usage
+    std::vector<bool> overBudget;
+
+    float threshold = 0.9f;
+    BudgetCallback budgetCallback;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
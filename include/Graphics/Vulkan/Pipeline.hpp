@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Core/ThreadPool.hpp"
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vulkan/vulkan_structs.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+class ShaderRegistry;
+
+struct ShaderStageDesc {
+    vk::ShaderStageFlagBits stage = vk::ShaderStageFlagBits::eVertex;
+    vk::ShaderModule module{VK_NULL_HANDLE};
+    std::string entryPoint = "main";
+    // Hash of the SPIR-V. When set it identifies the shader instead of the module handle, so pipelines built
+    // from separately created modules of the same code are deduplicated.
+    uint64_t codeHash = 0;
+    // File the stage was loaded from through a ShaderRegistry, empty otherwise. Only used to find the pipelines
+    // to rebuild when the file changes; it is not part of the stage's identity.
+    std::string path;
+
+    bool operator==(const ShaderStageDesc& other) const;
+};
+
+[[nodiscard]] inline vk::PipelineColorBlendAttachmentState OpaqueBlendAttachment() {
+    vk::PipelineColorBlendAttachmentState attachment{};
+    attachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                                vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+    attachment.blendEnable = vk::False;
+    attachment.srcColorBlendFactor = vk::BlendFactor::eOne;
+    attachment.dstColorBlendFactor = vk::BlendFactor::eZero;
+    attachment.colorBlendOp = vk::BlendOp::eAdd;
+    attachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+    attachment.dstAlphaBlendFactor = vk::BlendFactor::eZero;
+    attachment.alphaBlendOp = vk::BlendOp::eAdd;
+    return attachment;
+}
+
+// Complete description of a graphics pipeline. Everything that affects the built pipeline is part of the
+// description, so two equal descriptions can share one vk::Pipeline.
+struct GraphicsPipelineDesc {
+    std::vector<ShaderStageDesc> stages;
+
+    std::vector<vk::VertexInputBindingDescription> vertexBindings;
+    std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+    vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+
+    vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+    vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+    vk::FrontFace frontFace = vk::FrontFace::eClockwise;
+    float lineWidth = 1.0f;
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+
+    bool depthTest = false;
+    bool depthWrite = false;
+    vk::CompareOp depthCompare = vk::CompareOp::eLess;
+
+    std::vector<vk::PipelineColorBlendAttachmentState> blendAttachments{OpaqueBlendAttachment()};
+    std::vector<vk::DynamicState> dynamicStates{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+
+    vk::PipelineLayout layout{VK_NULL_HANDLE};
+    vk::RenderPass renderPass{VK_NULL_HANDLE};
+    uint32_t subpass = 0;
+
+    [[nodiscard]] uint64_t hash() const;
+    bool operator==(const GraphicsPipelineDesc& other) const = default;
+};
+
+// Refers to a registry entry rather than a vk::Pipeline, so it follows the entry when the pipeline is rebuilt
+// after a shader change. Resolve it each time commands are recorded instead of caching the result.
+class PipelineHandle {
+   public:
+    PipelineHandle() = default;
+    explicit PipelineHandle(const std::atomic<VkPipeline>* current) : current(current) {}
+
+    [[nodiscard]] vk::Pipeline get() const { return current ? current->load(std::memory_order_acquire) : nullptr; }
+    [[nodiscard]] bool isReady() const { return get() != VK_NULL_HANDLE; }
+
+   private:
+    const std::atomic<VkPipeline>* current = nullptr;
+};
+
+// Builds graphics pipelines on demand and returns the existing pipeline for a description it has seen before.
+// All pipelines go through one vk::PipelineCache that is loaded from and saved to disk, so driver-side shader
+// compilation is skipped on later launches.
+//
+// Pipelines are compiled on a pool of worker threads sharing the cache, which vkCreateGraphicsPipelines allows
+// without external synchronization. Every method is safe to call from any thread, except reload() and update()
+// which belong to the frame loop.
+class PipelineRegistry {
+   public:
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              std::filesystem::path cachePath,
+              DeletionQueue& deletionQueue,
+              size_t workerCount = 0);
+
+    // Starts building `desc` in the background unless an equal description was requested before. Shader
+    // modules referenced by `desc` must stay alive until the future is ready. The pipeline stays valid for
+    // the lifetime of the registry.
+    [[nodiscard]] std::shared_future<vk::Pipeline> getAsync(const GraphicsPipelineDesc& desc);
+    [[nodiscard]] std::vector<std::shared_future<vk::Pipeline>> build(std::span<const GraphicsPipelineDesc> descs);
+    // Blocking convenience wrapper around getAsync.
+    [[nodiscard]] vk::Pipeline get(const GraphicsPipelineDesc& desc) { return getAsync(desc).get(); }
+    // Like getAsync, but the handle keeps pointing at the current pipeline across hot reloads.
+    [[nodiscard]] PipelineHandle getHandle(const GraphicsPipelineDesc& desc);
+
+    // Starts rebuilding, in the background, every pipeline with a stage loaded from one of `paths`. The old
+    // pipelines stay in use until update() swaps the replacements in. Takes the modules `shaders` has retired and
+    // keeps them until every build that was already started or queued has finished.
+    void reload(std::span<const std::string> paths, ShaderRegistry& shaders);
+    // Called once per frame after the frame slot has been waited on. Swaps in finished rebuilds, the pipelines
+    // they replace go to the deletion queue. Releases retired shader modules nothing can compile from any more.
+    void update();
+
+    // Blocks until every requested pipeline has been built.
+    void wait() const;
+    // Writes the pipeline cache to disk. Called on shutdown.
+    void save() const;
+
+    [[nodiscard]] vk::PipelineCache getCache() const { return *cache; }
+    // For pipelines built outside the registry, e.g. compute pipelines, so they share the on-disk cache.
+    [[nodiscard]] const vk::raii::PipelineCache& getPipelineCache() const { return cache; }
+    [[nodiscard]] size_t size() const;
+
+   private:
+    struct Entry {
+        GraphicsPipelineDesc desc;
+        vk::raii::Pipeline pipeline{nullptr};
+        std::shared_future<vk::Pipeline> ready;
+        std::atomic<VkPipeline> current{VK_NULL_HANDLE};
+
+        // Rebuild after a shader change, written by a worker and swapped in by update(). Each rebuild waits for
+        // the previous one, so `pending` always ends up compiled from the latest `pendingDesc`.
+        GraphicsPipelineDesc pendingDesc;
+        vk::raii::Pipeline pending{nullptr};
+        std::shared_future<void> rebuild;
+    };
+
+    [[nodiscard]] Entry& findOrCreate(const GraphicsPipelineDesc& desc);
+    [[nodiscard]] vk::raii::Pipeline compile(const GraphicsPipelineDesc& desc) const;
+    [[nodiscard]] std::vector<uint8_t> loadCacheData() const;
+
+    const vk::raii::Device* device = nullptr;
+    DeletionQueue* deletionQueue = nullptr;
+    vk::raii::PipelineCache cache{nullptr};
+    std::filesystem::path cachePath;
+
+    // Identifies the device and driver the cache blob was produced by.
+    uint32_t vendorID = 0;
+    uint32_t deviceID = 0;
+    uint32_t driverVersion = 0;
+    std::array<uint8_t, VK_UUID_SIZE> cacheUUID{};
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, std::vector<std::unique_ptr<Entry>>> pipelines;
+    size_t count = 0;
+    size_t hits = 0;
+
+    // Shader modules replaced on disk, with the builds that were outstanding when they were replaced.
+    struct RetiredModules {
+        std::vector<vk::raii::ShaderModule> modules;
+        std::vector<std::shared_future<vk::Pipeline>> builds;
+        std::vector<std::shared_future<void>> rebuilds;
+    };
+
+    // Only touched from the frame loop.
+    std::vector<Entry*> rebuilding;
+    std::vector<RetiredModules> retiredModules;
+
+    // Declared last so the workers are joined before the entries and cache they write to go away.
+    std::unique_ptr<ThreadPool> workers;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
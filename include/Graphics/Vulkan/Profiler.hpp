@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+struct ScopeStats {
+    std::string name;
+    uint64_t samples = 0;
+    double lastMs = 0.0;
+    double minMs = 0.0;
+    double avgMs = 0.0;
+    double p99Ms = 0.0;
+};
+
+struct PipelineStatistics {
+    uint64_t inputAssemblyVertices = 0;
+    uint64_t inputAssemblyPrimitives = 0;
+    uint64_t vertexShaderInvocations = 0;
+    uint64_t clippingInvocations = 0;
+    uint64_t clippingPrimitives = 0;
+    uint64_t fragmentShaderInvocations = 0;
+};
+
+// Per-frame GPU timestamp profiler. Each frame in flight owns its own query pools, so results are read back
+// without waiting when the same frame slot comes around again, i.e. after it has been waited on.
+class GpuProfiler {
+   public:
+    static constexpr uint32_t kMaxScopes = 64;
+    static constexpr size_t kHistory = 256;
+    static constexpr uint32_t kInvalidScope = UINT32_MAX;
+
+    void init(const vk::raii::Device& device,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              uint32_t queueFamily,
+              size_t frameCount,
+              bool pipelineStatistics);
+
+    [[nodiscard]] bool isEnabled() const { return enabled; }
+    [[nodiscard]] bool hasPipelineStatistics() const { return statisticsEnabled; }
+
+    // Must be recorded outside of a render pass, at the start of the frame's command buffer.
+    void beginFrame(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex);
+
+    [[nodiscard]] uint32_t beginScope(const vk::raii::CommandBuffer& cmd,
+                                      std::string_view name,
+                                      vk::PipelineStageFlagBits stage = vk::PipelineStageFlagBits::eTopOfPipe);
+    void endScope(const vk::raii::CommandBuffer& cmd,
+                  uint32_t scope,
+                  vk::PipelineStageFlagBits stage = vk::PipelineStageFlagBits::eBottomOfPipe);
+
+    void beginPipelineStatistics(const vk::raii::CommandBuffer& cmd);
+    void endPipelineStatistics(const vk::raii::CommandBuffer& cmd);
+
+    [[nodiscard]] std::vector<ScopeStats> getStats() const;
+    [[nodiscard]] std::optional<ScopeStats> getStats(std::string_view name) const;
+    [[nodiscard]] const PipelineStatistics& getPipelineStatistics() const { return statistics; }
+
+    // Reads back the frames still in flight, oldest first. Only valid once the device is idle, e.g. before the
+    // final logSummary().
+    void collectPending();
+    void logSummary() const;
+
+   private:
+    struct FrameQueries {
+        vk::raii::QueryPool timestamps{nullptr};
+        vk::raii::QueryPool statistics{nullptr};
+        std::vector<uint32_t> scopeIds;  // scope id of each begin/end timestamp pair
+        bool statisticsWritten = false;
+    };
+
+    struct ScopeHistory {
+        std::string name;
+        std::vector<double> samples;  // ring of the last kHistory durations in ms
+        size_t next = 0;
+        uint64_t total = 0;
+    };
+
+    void collect(FrameQueries& queries);
+    [[nodiscard]] ScopeStats summarize(const ScopeHistory& history) const;
+
+    bool enabled = false;
+    bool statisticsEnabled = false;
+    double timestampPeriod = 1.0;  // nanoseconds per tick
+    uint64_t timestampMask = 0;
+
+    std::vector<FrameQueries> frames;
+    FrameQueries* current = nullptr;
+
+    std::unordered_map<std::string, uint32_t> scopeLookup;
+    std::vector<ScopeHistory> scopes;
+    PipelineStatistics statistics{};
+};
+
+// RAII helper for named scopes inside onRender.
+class GpuScope {
+   public:
+    GpuScope(GpuProfiler& profiler, const vk::raii::CommandBuffer& cmd, std::string_view name)
+        : profiler(profiler), cmd(cmd), scope(profiler.beginScope(cmd, name)) {}
+    ~GpuScope() { profiler.endScope(cmd, scope); }
+
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+
+   private:
+    GpuProfiler& profiler;
+    const vk::raii::CommandBuffer& cmd;
+    uint32_t scope;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -11,6 +11,9 @@ namespace Solaris::Graphics::Vulkan {
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily;  // only set for a family without graphics support
+
+    bool hasDedicatedTransfer() const { return transferFamily.has_value() && transferFamily != graphicsFamily; }
 
     bool isComplete() { return graphicsFamily.has_value() && presentFamily.has_value(); }
 };
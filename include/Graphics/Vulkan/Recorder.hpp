@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Core/JobSystem.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+// Records one render pass worth of draws on several threads. The draw list is split into contiguous slices, each
+// slice is recorded into a secondary command buffer as a job, and the secondaries are executed from the
+// primary in slice order, so the result matches recording the whole list on one thread.
+//
+// Every slice has its own command pool per frame in flight. Pools are never shared between threads and are reset
+// as a whole in beginFrame() instead of resetting individual command buffers.
+class ParallelRecorder {
+   public:
+    // Records items [begin, end) into `cmd`. Secondary command buffers inherit nothing but the render pass, so
+    // the callback must bind its pipeline, descriptor sets and buffers and set any dynamic state itself.
+    using SliceFn = std::function<void(const vk::raii::CommandBuffer& cmd, uint32_t begin, uint32_t end)>;
+
+    // One slice per job system worker.
+    void init(const vk::raii::Device& device, uint32_t queueFamily, size_t framesInFlight, JobSystem& jobs);
+
+    // Recycles every command buffer recorded for `frameIndex`. Only call once that frame slot has been waited on.
+    void beginFrame(uint32_t frameIndex);
+
+    // Records `itemCount` items in parallel and executes them in `primary`, which must be inside a render pass
+    // begun with vk::SubpassContents::eSecondaryCommandBuffers. Small lists are recorded in fewer slices, down
+    // to one, since every slice costs a command buffer and a job.
+    void record(const vk::raii::CommandBuffer& primary,
+                uint32_t frameIndex,
+                const vk::CommandBufferInheritanceInfo& inheritance,
+                uint32_t itemCount,
+                const SliceFn& recordSlice,
+                uint32_t minItemsPerSlice = 256);
+
+    [[nodiscard]] size_t getSliceCount() const { return sliceCount; }
+
+   private:
+    struct SlicePool {
+        vk::raii::CommandPool pool{nullptr};
+        std::vector<vk::raii::CommandBuffer> buffers;
+        size_t used = 0;
+    };
+
+    [[nodiscard]] const vk::raii::CommandBuffer& acquire(SlicePool& slice);
+
+    const vk::raii::Device* device = nullptr;
+    JobSystem* jobs = nullptr;
+    size_t sliceCount = 0;
+    std::vector<std::vector<SlicePool>> frames;  // [frame][slice]
+};
+
+}  // namespace Solaris::Graphics::Vulkan
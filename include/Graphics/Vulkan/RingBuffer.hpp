@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Graphics/Vulkan/Buffer.hpp"
+
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+namespace Solaris::Graphics::Vulkan {
+
+struct TransientAllocation {
+    void* data = nullptr;
+    vk::Buffer buffer{VK_NULL_HANDLE};
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize size = 0;
+
+    template <typename T>
+    [[nodiscard]] T* as() const {
+        return static_cast<T*>(data);
+    }
+};
+
+// Persistently mapped buffer split into one region per frame in flight. Allocations are a bump of the
+// current region's head and are valid until the same frame slot comes around again, so per-frame vertex,
+// index and uniform data costs a memcpy instead of a buffer creation and staging copy.
+//
+// Allocations belong to the frame being recorded, between beginFrame() and flush(): in an Application that is
+// onPreRender and onRender. onSimulate and onUpdate run before the ring is recycled for the frame, or a whole
+// frame ahead when pipelined, so their data would land in a region the GPU may still be reading.
+class FrameRingBuffer {
+   public:
+    static constexpr vk::DeviceSize kDefaultFrameSize = 4 * 1024 * 1024;
+
+    void init(vma::Allocator* allocator,
+              const vk::raii::PhysicalDevice& physicalDevice,
+              size_t frameCount,
+              vk::DeviceSize frameSize = kDefaultFrameSize);
+
+    // Reclaims the region of `frameIndex`. Only call once that frame slot has been waited on.
+    void beginFrame(uint32_t frameIndex);
+    // Makes this frame's writes visible to the device; call before submitting.
+    void flush();
+
+    // Safe to call from several recording threads at once. Throws outside of beginFrame() ... flush(). Alignments
+    // below 4 bytes, including 0, are raised to 4, the smallest any buffer offset needs.
+    [[nodiscard]] TransientAllocation allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16);
+    [[nodiscard]] TransientAllocation allocateUniform(vk::DeviceSize size) {
+        return allocate(size, uniformAlignment);
+    }
+    [[nodiscard]] TransientAllocation allocateStorage(vk::DeviceSize size) {
+        return allocate(size, storageAlignment);
+    }
+
+    template <typename T>
+    [[nodiscard]] TransientAllocation push(std::span<const T> data, vk::DeviceSize alignment = alignof(T)) {
+        auto alloc = allocate(data.size_bytes(), alignment);
+        std::memcpy(alloc.data, data.data(), data.size_bytes());
+        return alloc;
+    }
+
+    [[nodiscard]] vk::Buffer getBuffer() const { return buffer.getBuffer(); }
+    [[nodiscard]] vk::DeviceSize getFrameSize() const { return frameSize; }
+    [[nodiscard]] vk::DeviceSize getUsed() const { return head.load(std::memory_order_relaxed); }
+    [[nodiscard]] vk::DeviceSize getHighWaterMark() const { return highWater; }
+
+   private:
+    Buffer buffer;
+    std::byte* mapped = nullptr;
+    vk::DeviceSize frameSize = 0;
+    vk::DeviceSize base = 0;
+    std::atomic<vk::DeviceSize> head{0};
+    std::atomic<bool> recording{false};
+    vk::DeviceSize highWater = 0;
+    vk::DeviceSize uniformAlignment = 256;
+    vk::DeviceSize storageAlignment = 256;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -1,14 +1,75 @@
 #pragma once
 
+#include "Graphics/Vulkan/Pipeline.hpp"
+
 #include <vulkan/vulkan.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <span>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace Solaris::Graphics::Vulkan {
 
 std::vector<char> readFile(const std::string& fileName);
 vk::raii::ShaderModule createShaderModule(const vk::raii::Device& device, const std::vector<char>& code);
+vk::raii::ShaderModule createShaderModule(const vk::raii::Device& device, std::span<const uint32_t> code);
+[[nodiscard]] uint64_t hashShaderCode(const std::vector<char>& code);
+
+// Where the compiled shaders live. Development builds use the build tree's output directory, so rebuilding the
+// Shaders target is picked up by hot reload, release builds the `shaders` directory next to the executable.
+// Falls back to `shaders` relative to the working directory.
+[[nodiscard]] std::filesystem::path GetShaderDirectory();
+
+// Loads SPIR-V by mapping it read-only and keeps one vk::raii::ShaderModule per distinct code hash, so
+// pipelines sharing a shader share a module. In development builds on Linux the shader directory is watched
+// with inotify and changed files are reported through pollChanges().
+class ShaderRegistry {
+   public:
+    ShaderRegistry() = default;
+    ~ShaderRegistry();
+
+    ShaderRegistry(const ShaderRegistry&) = delete;
+    ShaderRegistry& operator=(const ShaderRegistry&) = delete;
+
+    void init(const vk::raii::Device& device, std::filesystem::path directory);
+
+    // `file` is relative to the registry's directory. The module stays alive until the file's code changes.
+    [[nodiscard]] ShaderStageDesc load(const std::string& file,
+                                       vk::ShaderStageFlagBits stage,
+                                       const std::string& entryPoint = "main");
+
+    // Reloads shaders whose files changed on disk since the last call and returns the ones whose code actually
+    // differs. Call from the main thread at a frame boundary. Modules no file refers to any more are set aside
+    // for takeRetired().
+    [[nodiscard]] std::vector<std::string> pollChanges();
+    // Hands over the modules replaced by pollChanges(). Pipelines still compiling may use them, so the caller keeps
+    // them alive until those builds have finished, see PipelineRegistry::reload.
+    [[nodiscard]] std::vector<vk::raii::ShaderModule> takeRetired();
+
+    [[nodiscard]] bool isWatching() const { return watcher.joinable(); }
+
+   private:
+    [[nodiscard]] uint64_t loadFile(const std::string& file);
+    void watch(std::stop_token stop);
+
+    const vk::raii::Device* device = nullptr;
+    std::filesystem::path directory;
+
+    std::mutex mutex;  // guards modules and files against load() from pipeline workers
+    std::unordered_map<uint64_t, vk::raii::ShaderModule> modules;
+    std::unordered_map<std::string, uint64_t> files;
+    std::vector<vk::raii::ShaderModule> retired;
+
+    std::mutex changedMutex;
+    std::set<std::string> changed;
+    std::jthread watcher;
+};
 
-}  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Graphics/Vulkan/Buffer.hpp"
+
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+class UploadManager;
+
+enum class StreamStatus : uint8_t { Ready, Failed, Cancelled };
+
+struct StreamRequest {
+    std::filesystem::path path;
+    vk::DeviceSize fileOffset = 0;
+    vk::DeviceSize size = 0;  // 0 reads to the end of the file
+    Buffer* dst = nullptr;    // must stay alive until onComplete has run
+    vk::DeviceSize dstOffset = 0;
+    int32_t priority = 0;  // higher is read first, equal priorities in request order
+    // Runs on the render thread from update(), once the data is usable on the graphics queue or the request
+    // has failed or been cancelled.
+    std::move_only_function<void(StreamStatus)> onComplete;
+    // When set, the data stays resident once onComplete has reported Ready and may be evicted under memory
+    // pressure: evict() runs this on the render thread, after which `dst` is the owner's to free or reuse.
+    std::move_only_function<void()> onEvict;
+};
+
+struct StreamHandle {
+    uint64_t id = 0;
+
+    [[nodiscard]] bool isValid() const { return id != 0; }
+};
+
+// Streams file contents into device buffers without blocking the render thread. A background I/O thread reads
+// requests in priority order with pread, straight into persistently mapped staging slots. Every frame, update()
+// hands the filled slots to the upload manager, which copies them on the transfer queue and tracks completion on
+// its timeline semaphore; a slot is reused once its copy has completed.
+//
+// Copies are limited to a byte budget per frame so that a burst of loads is spread over several frames instead
+// of stalling one. Large requests are read and copied in slot-sized chunks, and a request of higher priority
+// overtakes a large one between its chunks.
+//
+// Completed requests with an onEvict callback stay resident until their owner releases them or evict() drops
+// them. Context wires evict() to the memory tracker's budget callback, so a device-local heap nearing its budget
+// sheds streamed data before the driver starts paging.
+class AssetStreamer {
+   public:
+    struct Config {
+        uint32_t stagingSlots = 8;
+        vk::DeviceSize slotSize = 4 * 1024 * 1024;
+        vk::DeviceSize bytesPerFrame = 16 * 1024 * 1024;  // at least one chunk per frame is always copied
+        float evictionThreshold = 0.9f;  // share of a device-local heap's budget above which resident data is evicted
+    };
+
+    AssetStreamer() = default;
+    ~AssetStreamer();
+
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    void init(vma::Allocator* allocator,
+              const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+              UploadManager& uploads,
+              const Config& config);
+    void shutdown();
+
+    // Safe to call from any thread.
+    StreamHandle request(StreamRequest request);
+    // Drops a request that has not been fully copied yet. Returns false when it is already on its way to the
+    // GPU, or done. Chunks already copied may have overwritten part of the destination.
+    bool cancel(StreamHandle handle);
+
+    // Called once per frame on the render thread, before the frame's submit: recycles staging slots, records the
+    // copies of filled slots within the budget and runs the callbacks of finished requests.
+    void update();
+
+    // Drops resident requests whose destination lives in memory heap `heap`, lowest priority and oldest first,
+    // until `bytes` have been evicted, and returns how many were. Bytes evicted from the heap in the last few frames
+    // count towards `bytes`, their memory is usually still waiting on the deletion queue. Render thread only.
+    vk::DeviceSize evict(uint32_t heap, vk::DeviceSize bytes);
+    // Stops tracking resident data the owner frees by itself. Render thread only.
+    void release(StreamHandle handle);
+
+    [[nodiscard]] size_t pending() const;
+    [[nodiscard]] vk::DeviceSize getResidentBytes() const;
+
+   private:
+    struct Request {
+        StreamRequest desc;
+        vk::DeviceSize total = 0;  // known once the I/O thread has opened the file
+        vk::DeviceSize read = 0;
+        uint32_t chunksFilled = 0;  // read, not copied yet
+        uint64_t ticket = 0;        // upload ticket of the last chunk copied
+        bool opened = false;
+        bool reading = false;  // the I/O thread holds it outside the lock
+        bool allRead = false;
+        bool failed = false;
+        bool cancelled = false;
+    };
+
+    struct Chunk {
+        uint64_t request;
+        uint32_t slot;
+        vk::DeviceSize offset;  // into the request
+        vk::DeviceSize size;
+    };
+
+    struct InFlight {
+        uint32_t slot;
+        uint64_t ticket;
+    };
+
+    struct Resident {
+        uint64_t id = 0;
+        int32_t priority = 0;
+        uint32_t heap = 0;
+        vk::DeviceSize size = 0;
+        std::move_only_function<void()> onEvict;
+    };
+
+    struct Eviction {
+        uint64_t frame;
+        uint32_t heap;
+        vk::DeviceSize size;
+    };
+
+    void ioLoop(std::stop_token stop);
+    [[nodiscard]] bool isFinished(const Request& request) const;
+
+    UploadManager* uploads = nullptr;
+    Config config{};
+    std::vector<Buffer> slots;
+    std::vector<std::byte*> slotData;
+
+    mutable std::mutex mutex;
+    std::condition_variable_any wake;  // a request or a free slot for the I/O thread
+    std::unordered_map<uint64_t, Request> requests;
+    std::vector<uint64_t> queue;  // requests with data left to read
+    std::deque<Chunk> filled;
+    std::vector<uint32_t> freeSlots;
+    uint64_t nextId = 1;
+
+    // Render thread only
+    std::deque<InFlight> inFlight;
+    std::vector<Resident> resident;  // in completion order
+    std::deque<Eviction> recentEvictions;
+    std::vector<uint32_t> memoryTypeHeaps;
+    uint64_t frame = 0;
+
+    std::jthread io;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
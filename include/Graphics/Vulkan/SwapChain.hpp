@@ -15,7 +15,9 @@ struct SwapchainSupportDetails {
                                                             const vk::raii::PhysicalDevice&);
 
 vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
-vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
+// Returns `requested` when the surface supports it, FIFO otherwise since every surface supports it.
+vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes,
+                                         vk::PresentModeKHR requested);
 vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities, GLFWwindow* window);
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/QueueFamily.hpp"
+
+#include <vk_mem_alloc.hpp>
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+// Batches staging -> device copies into a single submission per flush. Completion is tracked with a timeline
+// semaphore: every flush returns a ticket, and the ticket is reached once the copied data is usable on the
+// graphics queue. When the device exposes a dedicated transfer family the copies run there and ownership of
+// the destination ranges is released to the graphics family. The copies then signal a second timeline of their
+// own, which the graphics-side acquire waits on, so each timeline is only ever signaled from one queue.
+class UploadManager {
+   public:
+    static constexpr vk::DeviceSize kStagingChunkSize = 8 * 1024 * 1024;
+
+    void init(const vk::raii::Device& device,
+              vma::Allocator* allocator,
+              const QueueFamilyIndices& families,
+              vk::Queue graphicsQueue,
+              vk::Queue transferQueue);
+
+    // Copies `data` into staging memory and records a copy into `dst`. `dst` must stay alive until the
+    // ticket of the flush that submits it has been reached.
+    void upload(Buffer& dst, const void* data, vk::DeviceSize size, vk::DeviceSize dstOffset = 0);
+    // Records a copy from staging memory the caller filled itself. Both buffers must stay alive until the
+    // ticket of the flush that submits it has been reached.
+    void copy(const Buffer& src, vk::DeviceSize srcOffset, Buffer& dst, vk::DeviceSize dstOffset, vk::DeviceSize size);
+
+    // Submits everything recorded since the last flush. Returns the ticket to wait on, or the previous
+    // ticket when nothing was pending.
+    uint64_t flush();
+    // Recycles command buffers and staging memory of batches the GPU has finished with.
+    void collect();
+
+    [[nodiscard]] bool isComplete(uint64_t ticket) const;
+    void wait(uint64_t ticket) const;
+
+    [[nodiscard]] uint64_t lastSubmitted() const { return submitted; }
+    [[nodiscard]] vk::Semaphore getSemaphore() const { return *timeline; }
+    [[nodiscard]] bool hasDedicatedTransferQueue() const { return dedicated; }
+
+   private:
+    struct StagingChunk {
+        Buffer buffer;
+        vk::DeviceSize size = 0;
+        vk::DeviceSize used = 0;
+    };
+
+    struct Batch {
+        vk::raii::CommandBuffer transferCmd{nullptr};
+        vk::raii::CommandBuffer acquireCmd{nullptr};  // graphics-side ownership acquire, dedicated transfer only
+        std::vector<StagingChunk> chunks;
+        std::vector<vk::BufferMemoryBarrier> ownership;
+        uint64_t ticket = 0;
+    };
+
+    Batch& openBatch();
+    StagingChunk& stagingFor(Batch& batch, vk::DeviceSize size);
+    void recordCopy(Batch& batch,
+                    vk::Buffer src,
+                    vk::DeviceSize srcOffset,
+                    const Buffer& dst,
+                    vk::DeviceSize dstOffset,
+                    vk::DeviceSize size);
+
+    const vk::raii::Device* device = nullptr;
+    vma::Allocator* allocator = nullptr;
+    vk::Queue graphicsQueue{nullptr};
+    vk::Queue transferQueue{nullptr};
+    uint32_t graphicsFamily = 0;
+    uint32_t transferFamily = 0;
+    bool dedicated = false;
+
+    vk::raii::CommandPool transferPool{nullptr};
+    vk::raii::CommandPool graphicsPool{nullptr};
+    vk::raii::Semaphore timeline{nullptr};      // signaled on the graphics queue, the tickets
+    vk::raii::Semaphore copyTimeline{nullptr};  // signaled on the dedicated transfer queue
+    uint64_t timelineValue = 0;
+    uint64_t copyValue = 0;
+    uint64_t submitted = 0;
+
+    std::optional<Batch> current;
+    std::deque<Batch> inFlight;
+    std::vector<Batch> freeBatches;
+    std::vector<StagingChunk> freeChunks;
+};
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Graphics/Vulkan/Pipeline.hpp"
+#include "Graphics/VertexLayout.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+
+namespace Solaris::Graphics::Vulkan {
+
+// Vertex input state of a VertexLayout, every stream advancing per vertex. Stream i reads binding i, which is
+// where GeometryArena::bind puts the arena's stream i; a layout of only the first streams works on the same arena.
+template <VertexStream... Streams>
+[[nodiscard]] std::vector<vk::VertexInputBindingDescription> GetVertexBindings() {
+    using Layout = VertexLayout<Streams...>;
+    std::vector<vk::VertexInputBindingDescription> bindings;
+    for (uint32_t i = 0; i < Layout::kStreamCount; i++) {
+        bindings.emplace_back(i, Layout::kStrides[i], vk::VertexInputRate::eVertex);
+    }
+    return bindings;
+}
+
+template <VertexStream... Streams>
+[[nodiscard]] std::vector<vk::VertexInputAttributeDescription> GetVertexAttributes() {
+    std::vector<vk::VertexInputAttributeDescription> attributes;
+    for (const auto& attribute : VertexLayout<Streams...>::kAttributes) {
+        attributes.emplace_back(attribute.location, attribute.binding, static_cast<vk::Format>(attribute.format),
+                                attribute.offset);
+    }
+    return attributes;
+}
+
+template <VertexStream... Streams>
+void SetVertexInput(GraphicsPipelineDesc& desc) {
+    desc.vertexBindings = GetVertexBindings<Streams...>();
+    desc.vertexAttributes = GetVertexAttributes<Streams...>();
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -1,6 +1,8 @@
 #include "Core/Application.hpp"
+#include "Graphics/Vulkan/Culling.hpp"
+#include "Graphics/Vulkan/Geometry.hpp"
 #include "Graphics/Vulkan/Shader.hpp"
-#include "include/Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/VertexInput.hpp"
 
 // #include <vulkan/vulkan.hpp>
 // #include <vulkan/vulkan_raii.hpp>
@@ -12,43 +14,23 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <vulkan/vulkan_structs.hpp>
 
+#include <span>
 #include <stdexcept>
 
+// 8 bytes per vertex instead of 20, the vertex fetch expands both to the floats the shader reads.
 struct Vertex {
-    glm::vec2 pos;
-    glm::vec3 color;
-
-    static vk::VertexInputBindingDescription getBindingDescription() {
-        vk::VertexInputBindingDescription bindingDescription{};
-        bindingDescription.setBinding(0);
-        bindingDescription.setStride(sizeof(Vertex));
-        bindingDescription.setInputRate(vk::VertexInputRate::eVertex);
-
-        return bindingDescription;
-    }
-    static std::array<vk::VertexInputAttributeDescription, 2> getAttributeDescriptions() {
-        std::array<vk::VertexInputAttributeDescription, 2> attributeDescriptions{};
-
-        attributeDescriptions[0].setBinding(0);
-        attributeDescriptions[0].setLocation(0);
-        attributeDescriptions[0].setFormat(vk::Format::eR32G32Sfloat);
-        attributeDescriptions[0].setOffset(offsetof(Vertex, pos));
-
-        attributeDescriptions[1].setBinding(0);
-        attributeDescriptions[1].setLocation(1);
-        attributeDescriptions[1].setFormat(vk::Format::eR32G32B32Sfloat);
-        attributeDescriptions[1].setOffset(offsetof(Vertex, color));
-
-        return attributeDescriptions;
-    }
+    Solaris::Graphics::Snorm16x2 pos;
+    Solaris::Graphics::Unorm8x4 color;
 };
 
+constexpr int16_t kHalf = Solaris::Graphics::PackSnorm16(0.5f);
+
 // clang-format off
 const std::vector<Vertex> vertices = {
-    {{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
-    {{0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
-    {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
-    {{-0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}}
+    {{-kHalf, -kHalf}, {255, 0, 0, 255}},
+    {{kHalf, -kHalf}, {0, 255, 0, 255}},
+    {{kHalf, kHalf}, {0, 0, 255, 255}},
+    {{-kHalf, kHalf}, {255, 255, 255, 255}}
 };
 
 const std::vector<uint16_t> indices = {
@@ -56,6 +38,11 @@ const std::vector<uint16_t> indices = {
 };
 // clang-format on
 
+// Everything the renderer needs from the simulation for one frame.
+struct FramePacket {
+    glm::mat4 viewProjection{1.0f};
+};
+
 class TriangleApplication final : public Application {
    public:
     TriangleApplication(){};
@@ -63,18 +50,55 @@ class TriangleApplication final : public Application {
 
    protected:
     void onInit() override {
-        mVertexBuffer.init(*ctx().allocator, vertices, ctx().commandPool, ctx().device, ctx().graphicsQueue);
-        mIndexBuffer.init(*ctx().allocator, indices, ctx().commandPool, ctx().device, ctx().graphicsQueue);
-        createPipeline();
+        // Compile on the registry's workers while the geometry is uploaded.
+        mPipeline = createPipeline();
+
+        Solaris::Graphics::Vulkan::GeometryArena::Config geometry{};
+        geometry.vertexStrides = {sizeof(Vertex)};
+        geometry.vertexCapacity = 1 << 16;
+        geometry.indexCapacity = 1 << 18;
+        // The index type is shared by every mesh in the arena, so it has to fit the largest one that may be added,
+        // not the quad. 8-bit indices only pay off in an arena reserved for small meshes.
+        geometry.indexType = vk::IndexType::eUint16;
+        mGeometry.init(&*ctx().allocator, ctx().allocator.getRelocatablePool(), ctx().uploads, ctx().deletionQueue,
+                       geometry);
+        mQuad = mGeometry.add(std::span(vertices), std::span(indices));
+
+        mCulling.init(ctx().device, &*ctx().allocator, ctx().shaders, ctx().pipelines.getPipelineCache(),
+                      ctx().frames.getAll().size(), 1024, 1, ctx().features.drawIndirectCount,
+                      ctx().features.multiDrawIndirect, ctx().features.drawIndirectFirstInstance);
+        auto quad = quadObject();
+        Solaris::Graphics::Vulkan::DrawBatch batch{0, 1};
+        mCulling.setObjects({&quad, 1}, {&batch, 1}, ctx().uploads);
+        mGeometryGeneration = mGeometry.getGeneration();
+
+        // The first frame's submit waits on this ticket.
+        ctx().uploads.flush();
+
+        ctx().pipelines.wait();
+    }
+    void onSimulate(float dt, uint32_t packet) override {
+        // The vertex shader outputs clip space directly, so the camera is the identity.
+        mFramePackets[packet].viewProjection = glm::mat4(1.0f);
+    }
+    void onPreRender(vk::raii::CommandBuffer& cmd, uint32_t imageIndex) override {
+        mGeometry.update(cmd);
+        if (mGeometry.getGeneration() != mGeometryGeneration) {
+            // The arena was compacted and the quad moved.
+            auto quad = quadObject();
+            mCulling.updateObjects(0, {&quad, 1}, ctx().transientBuffer);
+            mGeometryGeneration = mGeometry.getGeneration();
+        }
+
+        const auto& packet = mFramePackets[renderPacket()];
+        auto planes = Solaris::Graphics::Vulkan::ExtractFrustumPlanes(packet.viewProjection);
+        mCulling.cull(cmd, ctx().frames.getCurrentIndex(), planes);
     }
     void onRender(vk::raii::CommandBuffer& cmd, uint32_t imageIndex) override {
-        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *mPipeline);
+        Solaris::Graphics::Vulkan::GpuScope scope(ctx().profiler, cmd, "Triangle");
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, mPipeline.get());
 
-        vk::Buffer vbufs[] = {mVertexBuffer.getBuffer()};
-        vk::DeviceSize offs[] = {0};
-
-        cmd.bindVertexBuffers(0, vbufs, offs);
-        cmd.bindIndexBuffer(mIndexBuffer.getBuffer(), 0, vk::IndexType::eUint16);
+        mGeometry.bind(cmd);
 
         vk::Viewport viewport{};
         viewport.setX(0.0f);
@@ -91,129 +115,49 @@ class TriangleApplication final : public Application {
         scissor.setExtent(ctx().swapchainExtent);
 
         cmd.setScissor(0, {scissor});
-        cmd.drawIndexed(static_cast<uint32_t>(mIndexBuffer.getIndexCount()), 1, 0, 0, 0);
+        mCulling.draw(cmd, ctx().frames.getCurrentIndex(), 0);
     }
     void onShutdown() override {}
 
    private:
-    void createPipeline() {
-        auto vertCode = Solaris::Graphics::Vulkan::readFile("shaders/shader.vert.spv");
-        auto fragCode = Solaris::Graphics::Vulkan::readFile("shaders/shader.frag.spv");
-
-        auto vertShader = Solaris::Graphics::Vulkan::createShaderModule(ctx().device, vertCode);
-        auto fragShader = Solaris::Graphics::Vulkan::createShaderModule(ctx().device, fragCode);
-
-        vk::PipelineShaderStageCreateInfo vsi{};
-        vsi.setStage(vk::ShaderStageFlagBits::eVertex);
-        vsi.setModule(vertShader);
-        vsi.setPName("main");
-
-        vk::PipelineShaderStageCreateInfo fsi{};
-        fsi.setStage(vk::ShaderStageFlagBits::eFragment);
-        fsi.setModule(fragShader);
-        fsi.setPName("main");
-
-        vk::PipelineShaderStageCreateInfo shaderStages[] = {vsi, fsi};
-        std::vector<vk::DynamicState> dynamicStates = {
-            vk::DynamicState::eViewport,
-            vk::DynamicState::eScissor,
+    [[nodiscard]] Solaris::Graphics::Vulkan::GpuObject quadObject() const {
+        auto range = mGeometry.getRange(mQuad);
+        Solaris::Graphics::Vulkan::GpuObject quad{};
+        quad.sphere = {0.0f, 0.0f, 0.0f, 0.75f};
+        quad.firstIndex = range.firstIndex;
+        quad.indexCount = range.indexCount;
+        quad.vertexOffset = range.vertexOffset;
+        return quad;
+    }
+
+    Solaris::Graphics::Vulkan::PipelineHandle createPipeline() {
+        Solaris::Graphics::Vulkan::GraphicsPipelineDesc desc{};
+        desc.stages = {
+            ctx().shaders.load("shader.vert.spv", vk::ShaderStageFlagBits::eVertex),
+            ctx().shaders.load("shader.frag.spv", vk::ShaderStageFlagBits::eFragment),
         };
+        Solaris::Graphics::Vulkan::SetVertexInput<Vertex>(desc);
+        desc.cullMode = vk::CullModeFlagBits::eBack;
+        desc.frontFace = vk::FrontFace::eClockwise;
+        desc.layout = ctx().descriptors.getPipelineLayout();
+        desc.renderPass = ctx().renderPass;
 
-        vk::PipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates = dynamicStates.data();
-
-        vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
-
-        auto bindingDescription = Vertex::getBindingDescription();
-        auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
-        vertexInputInfo.vertexBindingDescriptionCount = 1;
-        vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-        vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-        vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
-        inputAssembly.topology = vk::PrimitiveTopology::eTriangleList;
-        inputAssembly.primitiveRestartEnable = vk::False;
-
-        vk::PipelineViewportStateCreateInfo viewportState{};
-        viewportState.viewportCount = 1;
-        viewportState.scissorCount = 1;
-
-        vk::PipelineRasterizationStateCreateInfo rasterizer{};
-        rasterizer.depthClampEnable = vk::False;
-        rasterizer.rasterizerDiscardEnable = vk::False;
-        rasterizer.polygonMode = vk::PolygonMode::eFill;
-        rasterizer.lineWidth = 1.0f;
-        rasterizer.cullMode = vk::CullModeFlagBits::eBack;
-        rasterizer.frontFace = vk::FrontFace::eClockwise;
-        rasterizer.depthBiasEnable = vk::False;
-
-        vk::PipelineMultisampleStateCreateInfo multisampling{};
-        multisampling.sampleShadingEnable = vk::False;
-        multisampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
-
-        vk::PipelineColorBlendAttachmentState colorBlendAttachment{};
-        colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-                                              vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
-        colorBlendAttachment.blendEnable = vk::False;
-        colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eOne;
-        colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eZero;
-        colorBlendAttachment.colorBlendOp = vk::BlendOp::eAdd;
-        colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
-        colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eZero;
-        colorBlendAttachment.alphaBlendOp = vk::BlendOp::eAdd;
-
-        vk::PipelineColorBlendStateCreateInfo colorBlending{};
-        colorBlending.logicOpEnable = vk::False;
-        colorBlending.logicOp = vk::LogicOp::eCopy;
-        colorBlending.attachmentCount = 1;
-        colorBlending.pAttachments = &colorBlendAttachment;
-        colorBlending.blendConstants[0] = 0.0f;
-        colorBlending.blendConstants[1] = 0.0f;
-        colorBlending.blendConstants[2] = 0.0f;
-        colorBlending.blendConstants[3] = 0.0f;
-
-        vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.setLayoutCount = 0;
-        pipelineLayoutInfo.pSetLayouts = nullptr;
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
-        pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-        mPipelineLayout = {ctx().device, pipelineLayoutInfo};
-
-        vk::GraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.setStageCount(2);
-        pipelineInfo.setPStages(shaderStages);
-        pipelineInfo.setPVertexInputState(&vertexInputInfo);
-        pipelineInfo.setPInputAssemblyState(&inputAssembly);
-        pipelineInfo.setPViewportState(&viewportState);
-        pipelineInfo.setPRasterizationState(&rasterizer);
-        pipelineInfo.setPMultisampleState(&multisampling);
-        pipelineInfo.setPDepthStencilState(nullptr);
-        pipelineInfo.setPColorBlendState(&colorBlending);
-        pipelineInfo.setPDynamicState(&dynamicState);
-        pipelineInfo.setLayout(mPipelineLayout);
-        pipelineInfo.setRenderPass(ctx().renderPass);
-        pipelineInfo.setSubpass(0);
-        pipelineInfo.setBasePipelineHandle(VK_NULL_HANDLE);
-        pipelineInfo.setBasePipelineIndex(-1);
-
-        mPipeline = ctx().device.createGraphicsPipeline(nullptr, pipelineInfo);
+        return ctx().pipelines.getHandle(desc);
     }
 
-    Solaris::Graphics::Vulkan::VertexBuffer mVertexBuffer;
-    Solaris::Graphics::Vulkan::IndexBuffer mIndexBuffer;
+    Solaris::FramePackets<FramePacket> mFramePackets;
+    Solaris::Graphics::Vulkan::GeometryArena mGeometry;
+    Solaris::Graphics::Vulkan::MeshHandle mQuad;
+    uint64_t mGeometryGeneration = 0;
+    Solaris::Graphics::Vulkan::GpuCulling mCulling;
 
-    vk::raii::PipelineLayout mPipelineLayout{nullptr};
-    vk::raii::Pipeline mPipeline{nullptr};
+    Solaris::Graphics::Vulkan::PipelineHandle mPipeline;  // owned by the context's pipeline registry
 };
 
 auto main(int argc, char** argv) -> int {
     try {
         TriangleApplication app;
-        app.Run();
+        app.Run(ParseCommandLine(argc, argv));
 
     } catch (std::runtime_error& err) {
         spdlog::error("{}", err.what());
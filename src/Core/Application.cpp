@@ -13,17 +13,106 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <vulkan/vulkan_to_string.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <stdexcept>
+#include <string>
+#include <thread>
 
 Application::~Application() {
+    try {
+        mJobs.wait(mUpdateJob);
+    } catch (...) {
+        // Already reported by the frame that rethrew it, or lost to the exception unwinding through here.
+    }
     mContext.device.waitIdle();
+    // While everything the callbacks refer to is still alive, instead of leaving the order to member destruction.
+    mContext.deletionQueue.flush();
     onShutdown();
 }
 
-void Application::Run() {
+static vk::PresentModeKHR parsePresentMode(const std::string& name) {
+    if (name == "immediate") {
+        return vk::PresentModeKHR::eImmediate;
+    } else if (name == "mailbox") {
+        return vk::PresentModeKHR::eMailbox;
+    } else if (name == "fifo") {
+        return vk::PresentModeKHR::eFifo;
+    } else if (name == "fifo-relaxed") {
+        return vk::PresentModeKHR::eFifoRelaxed;
+    }
+    throw std::runtime_error(std::format("Unknown present mode {}, expected immediate, mailbox, fifo or fifo-relaxed",
+                                         name));
+}
+
+ApplicationConfig ParseCommandLine(int argc, char** argv) {
+    ApplicationConfig config{};
+
+    auto value = [&](int& i) -> std::string {
+        if (i + 1 >= argc) {
+            throw std::runtime_error(std::format("Missing value for {}", argv[i]));
+        }
+        return argv[++i];
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--headless") {
+                config.headless = true;
+            } else if (arg == "--frames") {
+                config.frameCount = std::stoull(value(i));
+            } else if (arg == "--width") {
+                config.width = static_cast<uint32_t>(std::stoul(value(i)));
+            } else if (arg == "--height") {
+                config.height = static_cast<uint32_t>(std::stoul(value(i)));
+            } else if (arg == "--images") {
+                config.imageCount = static_cast<uint32_t>(std::stoul(value(i)));
+            } else if (arg == "--frames-in-flight") {
+                config.framesInFlight = static_cast<uint32_t>(std::stoul(value(i)));
+            } else if (arg == "--pipeline-stats") {
+                config.pipelineStatistics = true;
+            } else if (arg == "--workers") {
+                config.workerThreads = static_cast<uint32_t>(std::stoul(value(i)));
+            } else if (arg == "--no-pin") {
+                config.pinWorkers = false;
+            } else if (arg == "--pipelined") {
+                config.pipelined = true;
+            } else if (arg == "--present-mode") {
+                config.presentMode = parsePresentMode(value(i));
+            } else if (arg == "--fps") {
+                config.frameRateLimit = std::stod(value(i));
+            } else if (arg == "--background-fps") {
+                config.backgroundFrameRate = std::stod(value(i));
+            } else if (arg == "--low-latency") {
+                config.lowLatency = true;
+            } else if (arg == "--memory-json") {
+                config.memoryJson = value(i);
+            } else if (arg == "--no-defrag") {
+                config.defragment = false;
+            } else if (arg == "--stream-budget") {
+                config.streamBudget = static_cast<uint32_t>(std::stoul(value(i)));
+            } else {
+                throw std::runtime_error(std::format("Unknown argument {}", arg));
+            }
+        } catch (std::logic_error&) {
+            throw std::runtime_error(std::format("Invalid value for {}", arg));
+        }
+    }
+
+    if (config.width == 0 || config.height == 0 || config.imageCount == 0 || config.framesInFlight == 0) {
+        throw std::runtime_error("Resolution, image count and frames in flight must be non-zero");
+    }
+    return config;
+}
+
+void Application::Run(const ApplicationConfig& config) {
+    mConfig = config;
+
     initLogger();
-    initWindow();
+    if (!mConfig.headless) {
+        initWindow();
+    }
     initVulkan();
 
     onInit();
@@ -51,17 +140,15 @@ static void framebufferResizeCallback(GLFWwindow* window, int width, int height)
 }
 
 void Application::initWindow() {
-    const uint32_t WIDTH = 800;
-    const uint32_t HEIGHT = 600;
-
     if (glfwInit() == GLFW_FALSE) {
         throw std::runtime_error("Failed to initialize GLFW");
     }
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 
-    pWindow = glfwCreateWindow(WIDTH, HEIGHT, "solaris", nullptr, nullptr);
+    pWindow = glfwCreateWindow(static_cast<int>(mConfig.width), static_cast<int>(mConfig.height), "solaris", nullptr,
+                               nullptr);
     if (pWindow == nullptr) {
         throw std::runtime_error("Failed to create window");
     }
@@ -70,25 +157,155 @@ void Application::initWindow() {
 }
 
 void Application::initVulkan() {
+    mJobs.init(mConfig.workerThreads, mConfig.pinWorkers);
+    mContext.jobs = &mJobs;
+    mContext.requestedPresentMode = mConfig.presentMode;
+
     try {
-        mContext.init(pWindow);
+        if (mConfig.headless) {
+            mContext.initHeadless({mConfig.width, mConfig.height}, mConfig.imageCount, mConfig.framesInFlight);
+        } else {
+            mContext.init(pWindow, mConfig.framesInFlight);
+        }
+        mContext.initProfiler(mConfig.pipelineStatistics);
+        if (mConfig.defragment) {
+            mContext.initDefragmenter();
+        }
+        Solaris::Graphics::Vulkan::AssetStreamer::Config streaming{};
+        streaming.bytesPerFrame = vk::DeviceSize{mConfig.streamBudget} * 1024 * 1024;
+        mContext.initStreamer(streaming);
     } catch (vk::SystemError& err) {
         throw std::runtime_error(err.what());
     }
 }
 
-void Application::mainLoop() {
-    while (glfwWindowShouldClose(pWindow) == GLFW_FALSE) {
-        glfwPollEvents();
+bool Application::shouldClose(uint64_t frame) const {
+    if (mConfig.frameCount > 0 && frame >= mConfig.frameCount) {
+        return true;
+    }
+    return !mConfig.headless && glfwWindowShouldClose(pWindow) == GLFW_TRUE;
+}
+
+bool Application::simulate(float dt, uint32_t packet) {
+    try {
+        onSimulate(dt, packet);
+    } catch (...) {
+        // The render thread rethrows once it finds the exchange closed.
+        mSimulationError = std::current_exception();
+        mPackets.close();
+        return false;
+    }
+    mPackets.publish(packet);
+    return true;
+}
+
+void Application::simulationLoop() {
+    auto last = mLastTick;
+    while (true) {
+        // Waits here until the renderer has taken the previous packet, keeping it at most one frame behind.
+        uint32_t slot = mPackets.beginWrite();
+        if (slot == Solaris::FramePacketExchange::kClosed) {
+            return;
+        }
         auto now = std::chrono::steady_clock::now();
-        float dt = std::chrono::duration<float>(now - mLastTick).count();
-        mLastTick = now;
+        float dt = std::chrono::duration<float>(now - last).count();
+        last = now;
 
-        onUpdate(dt);
-        drawFrame();
+        if (!simulate(dt, slot)) {
+            return;
+        }
     }
+}
+
+bool Application::paceFrame() {
+    double rate = mConfig.frameRateLimit;
+    if (!mConfig.headless) {
+        // Nothing is visible, so render nothing until the window is restored. A zero-sized framebuffer cannot
+        // have a swapchain either.
+        int width = 0, height = 0;
+        glfwGetFramebufferSize(pWindow, &width, &height);
+        if (glfwGetWindowAttrib(pWindow, GLFW_ICONIFIED) == GLFW_TRUE || width == 0 || height == 0) {
+            glfwWaitEvents();
+            return false;
+        }
+        if (glfwGetWindowAttrib(pWindow, GLFW_FOCUSED) == GLFW_FALSE && mConfig.backgroundFrameRate > 0.0) {
+            rate = rate > 0.0 ? std::min(rate, mConfig.backgroundFrameRate) : mConfig.backgroundFrameRate;
+        }
+    }
+    mLimiter.setTargetRate(rate);
+    mLimiter.wait();
+
+    if (mConfig.lowLatency) {
+        mContext.waitForLastPresent();
+    }
+    return true;
+}
+
+void Application::mainLoop() {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t frame = 0;
+
+    // Declared before the loop so that it is joined after the exchange is closed, on every exit path.
+    std::jthread simulation;
+    if (mConfig.pipelined) {
+        simulation = std::jthread([this] { simulationLoop(); });
+    }
+
+    try {
+        while (!shouldClose(frame)) {
+            if (!paceFrame()) {
+                continue;
+            }
+            // Sampled as late as possible, after pacing.
+            if (!mConfig.headless) {
+                glfwPollEvents();
+            }
+            if (!mConfig.pipelined) {
+                auto now = std::chrono::steady_clock::now();
+                float dt = std::chrono::duration<float>(now - mLastTick).count();
+                mLastTick = now;
+
+                // The update overlaps the wait for the frame slot; drawFrame joins it before recording.
+                // Never blocks, the previous packet was released after the last frame.
+                uint32_t slot = mPackets.beginWrite();
+                mJobs.run([this, dt, slot] { (void)simulate(dt, slot); }, mUpdateJob);
+            }
+            // A skipped frame still releases its packet, the next simulation step is computed from the real dt.
+            bool submitted = drawFrame();
+            mPackets.release(mRenderPacket);
+            if (submitted) {
+                frame++;
+            }
+        }
+    } catch (...) {
+        mPackets.close();
+        throw;
+    }
+    mPackets.close();
 
     mContext.device.waitIdle();
+    mContext.defragmenter.shutdown();
+    mContext.profiler.collectPending();
+    mContext.profiler.logSummary();
+    mContext.memory.logSummary();
+    mContext.defragmenter.logSummary();
+    mJobs.logSummary();
+    if (!mConfig.memoryJson.empty()) {
+        mContext.memory.dumpJson(mConfig.memoryJson);
+    }
+    mContext.pipelines.save();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Rendered {} frames in {:.3f}s ({:.1f} fps).", frame, elapsed,
+                 elapsed > 0.0 ? static_cast<double>(frame) / elapsed : 0.0);
+}
+
+vk::CommandBufferInheritanceInfo Application::renderPassInheritance(uint32_t imageIndex) const {
+    vk::CommandBufferInheritanceInfo inheritance{};
+    inheritance.setRenderPass(mContext.renderPass);
+    inheritance.setSubpass(0);
+    inheritance.setFramebuffer(mContext.swapchainFramebuffers[imageIndex]);
+    return inheritance;
 }
 
 void Application::recordCommandBuffer(const vk::raii::CommandBuffer& commandBuffer, uint32_t imageIndex) {
@@ -97,6 +314,16 @@ void Application::recordCommandBuffer(const vk::raii::CommandBuffer& commandBuff
 
     commandBuffer.begin(beginInfo);
 
+    auto& profiler = mContext.profiler;
+    profiler.beginFrame(commandBuffer, mContext.frames.getCurrentIndex());
+    // Moves land before anything else in the frame reads the buffers.
+    mContext.defragmenter.update(commandBuffer);
+    onPreRender(const_cast<vk::raii::CommandBuffer&>(commandBuffer), imageIndex);
+
+    // Compaction and culling dispatches above are left out of the pass's time and statistics.
+    uint32_t renderPassScope = profiler.beginScope(commandBuffer, "RenderPass");
+    profiler.beginPipelineStatistics(commandBuffer);
+
     vk::RenderPassBeginInfo renderPassInfo{};
     renderPassInfo.setRenderPass(mContext.renderPass);
     renderPassInfo.setFramebuffer(mContext.swapchainFramebuffers[imageIndex]);
@@ -108,176 +335,127 @@ void Application::recordCommandBuffer(const vk::raii::CommandBuffer& commandBuff
     renderPassInfo.setClearValueCount(1);
     renderPassInfo.setPClearValues(&clearColor);
 
-    commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+    if (recordsInParallel()) {
+        commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+    } else {
+        commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+        mContext.descriptors.bind(commandBuffer, vk::PipelineBindPoint::eGraphics);
+    }
     onRender(const_cast<vk::raii::CommandBuffer&>(commandBuffer), imageIndex);
 
     commandBuffer.endRenderPass();
+
+    profiler.endPipelineStatistics(commandBuffer);
+    profiler.endScope(commandBuffer, renderPassScope);
     commandBuffer.end();
 }
 
-void Application::drawFrame() {
+bool Application::drawFrame() {
     auto& frame = mContext.frames.getCurrentFrame();
 
-    if (auto result = mContext.device.waitForFences({frame.inFlightFence}, vk::True, UINT64_MAX);
-        result != vk::Result::eSuccess) {
-        throw std::runtime_error(std::format("{}", vk::to_string(result)));
+    mContext.frames.waitCurrent(mContext.device);
+    mJobs.wait(mUpdateJob);
+    mRenderPacket = mPackets.acquire();
+    if (mRenderPacket == Solaris::FramePacketExchange::kClosed) {
+        std::rethrow_exception(mSimulationError);
     }
-    mContext.device.resetFences({frame.inFlightFence});
-
-    vk::AcquireNextImageInfoKHR acquireInfo{};
-    acquireInfo.setSwapchain(mContext.swapchain);
-    acquireInfo.setSemaphore(frame.imageAvailableSemaphore);
-    acquireInfo.setDeviceMask(1);
-    acquireInfo.setTimeout(UINT64_MAX);
+    mContext.beginFrame();
+
+    uint32_t imageIndex = 0;
+    if (mContext.headless) {
+        // Offscreen images are handed out round-robin; the frame wait already guards their reuse.
+        imageIndex = mContext.acquireOffscreenImage();
+    } else {
+        // paceFrame() has made sure the framebuffer is not zero-sized.
+        if (mSwapchainOutOfDate || mFramebufferResized) {
+            mContext.recreateSwapchain(pWindow);
+            mSwapchainOutOfDate = false;
+            mFramebufferResized = false;
+        }
 
-    auto acquireRes = mContext.device.acquireNextImage2KHR(acquireInfo);
-    uint32_t imageIndex = acquireRes.second;
+        vk::AcquireNextImageInfoKHR acquireInfo{};
+        acquireInfo.setSwapchain(mContext.swapchain);
+        acquireInfo.setSemaphore(frame.imageAvailableSemaphore);
+        acquireInfo.setDeviceMask(1);
+        acquireInfo.setTimeout(UINT64_MAX);
+
+        try {
+            auto acquireRes = mContext.device.acquireNextImage2KHR(acquireInfo);
+            imageIndex = acquireRes.second;
+            mContext.onImageAcquired();
+            // A suboptimal image is still presentable, recreate after this frame.
+            mSwapchainOutOfDate = acquireRes.first == vk::Result::eSuboptimalKHR;
+        } catch (vk::OutOfDateKHRError&) {
+            // Nothing was acquired, so the frame is skipped and the swapchain recreated on the next one.
+            mSwapchainOutOfDate = true;
+            return false;
+        }
+    }
 
     frame.commandBuffer.reset();
     recordCommandBuffer(frame.commandBuffer, imageIndex);
+    mContext.transientBuffer.flush();
 
+    // Wait on the image (windowed only) and on every upload submitted so far. Signal the frame timeline and,
+    // windowed, the image's present semaphore. Binary semaphores' entries in the value arrays are ignored.
     vk::SubmitInfo submitInfo{};
-    vk::Semaphore waitSemaphores[] = {frame.imageAvailableSemaphore};
-    vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
-    submitInfo.setWaitSemaphoreCount(1);
+    vk::Semaphore waitSemaphores[] = {mContext.uploads.getSemaphore(), frame.imageAvailableSemaphore};
+    vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eAllCommands,
+                                           vk::PipelineStageFlagBits::eColorAttachmentOutput};
+    uint64_t waitValues[] = {mContext.uploads.lastSubmitted(), 0};
+    uint32_t waitCount = mContext.headless ? 1 : 2;
+
+    vk::Semaphore presentSemaphore = mContext.headless ? vk::Semaphore{} : *mContext.presentSemaphores[imageIndex];
+    vk::Semaphore signalSemaphores[] = {mContext.frames.getTimeline(), presentSemaphore};
+    uint64_t signalValues[] = {mContext.frames.nextSignalValue(), 0};
+    uint32_t signalCount = mContext.headless ? 1 : 2;
+
+    vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.setWaitSemaphoreValueCount(waitCount);
+    timelineInfo.setPWaitSemaphoreValues(waitValues);
+    timelineInfo.setSignalSemaphoreValueCount(signalCount);
+    timelineInfo.setPSignalSemaphoreValues(signalValues);
+
+    submitInfo.setPNext(&timelineInfo);
+    submitInfo.setWaitSemaphoreCount(waitCount);
     submitInfo.setPWaitSemaphores(waitSemaphores);
     submitInfo.setPWaitDstStageMask(waitStages);
     submitInfo.setCommandBufferCount(1);
     submitInfo.setPCommandBuffers(&*frame.commandBuffer);
-
-    vk::Semaphore signalSemaphores[] = {frame.renderFinishedSemaphore};
-    submitInfo.setSignalSemaphoreCount(1);
+    submitInfo.setSignalSemaphoreCount(signalCount);
     submitInfo.setPSignalSemaphores(signalSemaphores);
 
-    mContext.graphicsQueue.submit({submitInfo}, frame.inFlightFence);
+    mContext.graphicsQueue.submit({submitInfo});
+
+    if (mContext.headless) {
+        mContext.frames.updateFrame();
+        return true;
+    }
 
     vk::PresentInfoKHR presentInfo{};
+    vk::PresentIdKHR presentIdInfo{};
+    uint64_t presentId = 0;
+    if (mContext.features.presentWait) {
+        presentId = ++mContext.presentId;
+        presentIdInfo.setPresentIds(presentId);
+        presentInfo.setPNext(&presentIdInfo);
+    }
     presentInfo.setWaitSemaphoreCount(1);
-    presentInfo.setPWaitSemaphores(signalSemaphores);
+    presentInfo.setPWaitSemaphores(&presentSemaphore);
     vk::SwapchainKHR swapChains[] = {mContext.swapchain};
     presentInfo.setSwapchainCount(1);
     presentInfo.setPSwapchains(swapChains);
     presentInfo.setPImageIndices(&imageIndex);
 
-    if (auto result = mContext.presentQueue.presentKHR(presentInfo);
-        result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || mFramebufferResized) {
-        int width = 0, height = 0;
-        glfwGetFramebufferSize(pWindow, &width, &height);
-        while (width == 0 || height == 0) {
-            glfwGetFramebufferSize(pWindow, &width, &height);
-            glfwWaitEvents();
+    // Recreation waits for the next frame, which knows whether the window is still zero-sized.
+    try {
+        if (mContext.presentQueue.presentKHR(presentInfo) == vk::Result::eSuboptimalKHR) {
+            mSwapchainOutOfDate = true;
         }
-        mContext.recreateSwapchain(pWindow);
-        mFramebufferResized = false;
+    } catch (vk::OutOfDateKHRError&) {
+        mSwapchainOutOfDate = true;
     }
 
     mContext.frames.updateFrame();
+    return true;
 }
-
-//     vk::CommandBufferBeginInfo beginInfo{};
-//     beginInfo.setPInheritanceInfo(nullptr);
-
-//     commandBuffer.begin(beginInfo);
-
-//     vk::RenderPassBeginInfo renderPassInfo{};
-//     renderPassInfo.setRenderPass(mContext.renderPass);
-//     renderPassInfo.setFramebuffer(mContext.swapchainFramebuffers[imageIndex]);
-//     renderPassInfo.renderArea.setOffset({0, 0});
-//     renderPassInfo.renderArea.setExtent(mContext.swapchainExtent);
-
-//     vk::ClearValue clearColor;
-//     clearColor.color = vk::ClearColorValue(std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f});
-//     renderPassInfo.setClearValueCount(1);
-//     renderPassInfo.setPClearValues(&clearColor);
-
-//     commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
-//     commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, mContext.pipeline);
-
-//     vk::Buffer vertexBuffers[] = {mContext.vertexBuffer.getBuffer()};
-//     vk::DeviceSize offsets[] = {0};
-
-//     commandBuffer.bindVertexBuffers(0, vertexBuffers, offsets);
-//     commandBuffer.bindIndexBuffer(mContext.indexBuffer.getBuffer(), 0, vk::IndexType::eUint16);
-
-//     vk::Viewport viewport{};
-//     viewport.setX(0.0f);
-//     viewport.setY(0.0f);
-//     viewport.setWidth(static_cast<float>(mContext.swapchainExtent.width));
-//     viewport.setHeight(static_cast<float>(mContext.swapchainExtent.height));
-//     viewport.setMinDepth(0.0f);
-//     viewport.setMaxDepth(1.0f);
-
-//     commandBuffer.setViewport(0, {viewport});
-
-//     vk::Rect2D scissor{};
-//     scissor.setOffset({0, 0});
-//     scissor.setExtent(mContext.swapchainExtent);
-
-//     commandBuffer.setScissor(0, {scissor});
-//     commandBuffer.drawIndexed(static_cast<uint32_t>(mContext.indexBuffer.getIndexCount()), 1, 0, 0, 0);
-
-//     commandBuffer.endRenderPass();
-//     commandBuffer.end();
-// }
-
-// void Application::drawFrame() {
-//     auto& frame = mContext.frames.getCurrentFrame();
-
-//     if (auto result = mContext.device.waitForFences({frame.inFlightFence}, vk::True, UINT64_MAX);
-//         result != vk::Result::eSuccess) {
-//         throw std::runtime_error(std::format("{}", vk::to_string(result)));
-//     }
-//     mContext.device.resetFences({frame.inFlightFence});
-
-//     vk::AcquireNextImageInfoKHR acquireInfo{};
-//     acquireInfo.setSwapchain(mContext.swapchain);
-//     acquireInfo.setSemaphore(frame.imageAvailableSemaphore);
-//     acquireInfo.setDeviceMask(1);
-//     acquireInfo.setTimeout(UINT64_MAX);
-
-//     auto result = mContext.device.acquireNextImage2KHR(acquireInfo);
-//     uint32_t imageIndex = result.second;
-
-//     frame.commandBuffer.reset();
-//     recordCommandBuffer(frame.commandBuffer, imageIndex);
-
-//     vk::SubmitInfo submitInfo{};
-//     vk::Semaphore waitSemaphores[] = {frame.imageAvailableSemaphore};
-//     vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
-//     submitInfo.setWaitSemaphoreCount(1);
-//     submitInfo.setPWaitSemaphores(waitSemaphores);
-//     submitInfo.setPWaitDstStageMask(waitStages);
-//     submitInfo.setCommandBufferCount(1);
-//     submitInfo.setPCommandBuffers(&*frame.commandBuffer);
-
-//     vk::Semaphore signalSemaphores[] = {frame.renderFinishedSemaphore};
-//     submitInfo.setSignalSemaphoreCount(1);
-//     submitInfo.setPSignalSemaphores(signalSemaphores);
-
-//     mContext.graphicsQueue.submit({submitInfo}, frame.inFlightFence);
-
-//     vk::PresentInfoKHR presentInfo{};
-//     presentInfo.setWaitSemaphoreCount(1);
-//     presentInfo.setPWaitSemaphores(signalSemaphores);
-
-//     vk::SwapchainKHR swapChains[] = {mContext.swapchain};
-//     presentInfo.setSwapchainCount(1);
-//     presentInfo.setPSwapchains(swapChains);
-//     presentInfo.setPImageIndices(&imageIndex);
-//     presentInfo.setPResults(nullptr);
-
-//     if (auto result = mContext.presentQueue.presentKHR(presentInfo);
-//         result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || mFramebufferResized) {
-//         int width = 0, height = 0;
-//         glfwGetFramebufferSize(pWindow, &width, &height);
-//         while (width == 0 || height == 0) {
-//             glfwGetFramebufferSize(pWindow, &width, &height);
-//             glfwWaitEvents();
-//         }
-
-//         mContext.recreateSwapchain(pWindow);
-//         mFramebufferResized = false;
-//     }
-
-//     mContext.frames.updateFrame();
-// }
@@ -0,0 +1,47 @@
+#include "Core/FrameLimiter.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace Solaris {
+
+constexpr auto minSpinMargin = std::chrono::microseconds(200);
+constexpr auto maxSpinMargin = std::chrono::milliseconds(4);
+
+void FrameLimiter::setTargetRate(double framesPerSecond) {
+    if (framesPerSecond == targetRate) {
+        return;
+    }
+    targetRate = framesPerSecond;
+    period = framesPerSecond > 0.0
+                 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond))
+                 : Clock::duration{};
+    next = {};
+}
+
+void FrameLimiter::wait() {
+    if (period == Clock::duration{}) {
+        return;
+    }
+
+    auto now = Clock::now();
+    if (next <= now) {
+        next = now + period;
+        return;
+    }
+
+    auto wake = next - spinMargin;
+    if (now < wake) {
+        std::this_thread::sleep_until(wake);
+        // Grow the margin right away when the sleep overshot it, shrink it slowly while it is too generous.
+        auto late = Clock::now() - wake;
+        spinMargin = std::clamp<Clock::duration>(std::max(late + late / 4, spinMargin - spinMargin / 16),
+                                                 minSpinMargin, maxSpinMargin);
+    }
+    while (Clock::now() < next) {
+        std::this_thread::yield();
+    }
+    next += period;
+}
+
+}  // namespace Solaris
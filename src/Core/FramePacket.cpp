@@ -0,0 +1,59 @@
+#include "Core/FramePacket.hpp"
+
+#include <algorithm>
+
+namespace Solaris {
+
+uint32_t FramePacketExchange::beginWrite() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return closed || std::ranges::find(states, State::Ready) == states.end(); });
+    if (closed) {
+        return kClosed;
+    }
+
+    // With no packet waiting, at most one slot is being read and the other one is free.
+    auto slot = static_cast<uint32_t>(std::ranges::find(states, State::Free) - states.begin());
+    states[slot] = State::Writing;
+    return slot;
+}
+
+void FramePacketExchange::publish(uint32_t slot) {
+    {
+        std::lock_guard lock(mutex);
+        states[slot] = State::Ready;
+    }
+    changed.notify_all();
+}
+
+uint32_t FramePacketExchange::acquire() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return closed || std::ranges::find(states, State::Ready) != states.end(); });
+    if (closed) {
+        return kClosed;
+    }
+
+    auto slot = static_cast<uint32_t>(std::ranges::find(states, State::Ready) - states.begin());
+    states[slot] = State::Reading;
+    lock.unlock();
+    // The simulation may start on the next packet now.
+    changed.notify_all();
+    return slot;
+}
+
+void FramePacketExchange::release(uint32_t slot) {
+    {
+        std::lock_guard lock(mutex);
+        states[slot] = State::Free;
+    }
+    changed.notify_all();
+}
+
+void FramePacketExchange::close() {
+    {
+        std::lock_guard lock(mutex);
+        closed = true;
+    }
+    changed.notify_all();
+}
+
+}  // namespace Solaris
@@ -0,0 +1,307 @@
+#include "Core/JobSystem.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Solaris {
+
+namespace {
+
+struct WorkerIdentity {
+    const JobSystem* owner = nullptr;
+    int index = -1;
+};
+
+thread_local WorkerIdentity currentIdentity{};
+// Jobs run from wait() inside another job are nested; only the outermost one counts towards busy time.
+thread_local int jobDepth = 0;
+
+// Rounds of stealing before an idle worker goes to sleep.
+constexpr int spinRounds = 64;
+
+}  // namespace
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+void JobSystem::init(size_t workerCount, bool pin) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    pinned = pin;
+
+    workers.resize(workerCount);
+    for (auto& worker : workers) {
+        worker = std::make_unique<Worker>();
+    }
+
+    currentIdentity = {this, 0};
+    for (size_t i = 1; i < workerCount; i++) {
+        workers[i]->thread = std::thread([this, i] { workerLoop(i); });
+    }
+
+    resetStats();
+    // The calling thread keeps its affinity, it is usually the main thread and not only a job worker.
+    if (pinned && workerCount > 1) {
+        spdlog::info("Job system running on {} workers, {} worker threads pinned to cores, the calling thread not.",
+                     workerCount, workerCount - 1);
+    } else {
+        spdlog::info("Job system running on {} workers, none pinned.", workerCount);
+    }
+}
+
+void JobSystem::shutdown() {
+    if (workers.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    // The workers drain the queues before they exit; without any, whatever is left runs here so that no counter
+    // is left waiting for a job that was dropped.
+    while (tryRunOne(0)) {
+    }
+    workers.clear();
+    currentIdentity = {};
+}
+
+int JobSystem::currentWorker() const {
+    return currentIdentity.owner == this ? currentIdentity.index : -1;
+}
+
+void JobSystem::pinCurrentThread(size_t core) const {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % std::max(1u, std::thread::hardware_concurrency()), &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        spdlog::warn("Failed to pin job worker {} to a core.", core);
+    }
+#else
+    (void)core;
+#endif
+}
+
+void JobSystem::push(size_t worker, Job job) {
+    {
+        std::lock_guard lock(workers[worker]->mutex);
+        workers[worker]->jobs.push_back(std::move(job));
+    }
+    // Pairs with the sleeper's increment of `sleeping` before it checks `queued`: either it sees this job, or
+    // this sees it sleeping and notifies under the lock, once it is actually waiting.
+    queued.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+void JobSystem::run(Job job, JobCounter& counter) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    Job wrapped = [job = std::move(job), &counter]() mutable {
+        try {
+            job();
+        } catch (...) {
+            std::lock_guard lock(counter.errorMutex);
+            if (!counter.error) {
+                counter.error = std::current_exception();
+            }
+        }
+        counter.pending.fetch_sub(1, std::memory_order_release);
+    };
+
+    // Threads outside the job system spread their jobs over the workers round-robin.
+    int self = currentWorker();
+    size_t target = self >= 0 ? static_cast<size_t>(self)
+                              : nextInjection.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    push(target, std::move(wrapped));
+}
+
+bool JobSystem::tryRunOne(size_t worker) {
+    Job job;
+    bool stolen = false;
+
+    if (worker < workers.size()) {
+        auto& own = *workers[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+        }
+    }
+
+    if (!job) {
+        // Steal the oldest job of another worker, it is the most likely to spawn more work.
+        for (size_t i = 1; i <= workers.size() && !job; i++) {
+            auto& victim = *workers[(worker + i) % workers.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                stolen = true;
+            }
+        }
+    }
+
+    if (!job) {
+        return false;
+    }
+    queued.fetch_sub(1, std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    jobDepth++;
+    job();
+    jobDepth--;
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    if (worker < workers.size()) {
+        auto& self = *workers[worker];
+        self.executed.fetch_add(1, std::memory_order_relaxed);
+        if (jobDepth == 0) {
+            self.busyNs.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+        }
+        if (stolen) {
+            self.steals.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    int self = currentWorker();
+    size_t worker = self >= 0 ? static_cast<size_t>(self) : workers.size();
+    while (!counter.isDone()) {
+        if (!tryRunOne(worker)) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard lock(counter.errorMutex);
+        error = std::exchange(counter.error, nullptr);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::workerLoop(size_t index) {
+    currentIdentity = {this, static_cast<int>(index)};
+    if (pinned) {
+        pinCurrentThread(index);
+    }
+
+    while (true) {
+        bool ran = false;
+        for (int i = 0; i < spinRounds && !ran; i++) {
+            ran = tryRunOne(index);
+        }
+        if (ran) {
+            continue;
+        }
+        // On shutdown the queued jobs still run, their counters would never reach zero otherwise. A job still
+        // running elsewhere may queue more, its worker only exits once it has run those too.
+        if (stopping.load(std::memory_order_acquire) && queued.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        sleeping.fetch_add(1, std::memory_order_seq_cst);
+        wake.wait(lock, [&] {
+            return stopping.load(std::memory_order_relaxed) || queued.load(std::memory_order_seq_cst) > 0;
+        });
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void JobSystem::parallelFor(uint32_t count,
+                            uint32_t minBatch,
+                            const std::function<void(uint32_t begin, uint32_t end)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    // A few batches per worker leaves room for stealing to even out uneven batches.
+    uint32_t batches = std::clamp<uint32_t>(count / std::max(minBatch, 1u), 1,
+                                            static_cast<uint32_t>(workers.size() * 4));
+    uint32_t perBatch = (count + batches - 1) / batches;
+
+    JobCounter counter;
+    for (uint32_t begin = perBatch; begin < count; begin += perBatch) {
+        uint32_t end = std::min(count, begin + perBatch);
+        run([&fn, begin, end] { fn(begin, end); }, counter);
+    }
+    // The caller takes the first batch itself. The other batches reference `fn` and `counter`, so they must finish
+    // before either goes out of scope, even when this one throws.
+    try {
+        fn(0, std::min(count, perBatch));
+    } catch (...) {
+        try {
+            wait(counter);
+        } catch (...) {
+            // The caller's own exception wins.
+        }
+        throw;
+    }
+    wait(counter);
+}
+
+std::vector<WorkerStats> JobSystem::getStats() const {
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - statsStart).count();
+
+    std::vector<WorkerStats> stats;
+    stats.reserve(workers.size());
+    for (const auto& worker : workers) {
+        WorkerStats s{};
+        s.jobs = worker->executed.load(std::memory_order_relaxed);
+        s.steals = worker->steals.load(std::memory_order_relaxed);
+        s.busyMs = static_cast<double>(worker->busyNs.load(std::memory_order_relaxed)) / 1e6;
+        s.utilization = wallMs > 0.0 ? s.busyMs / wallMs : 0.0;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void JobSystem::resetStats() {
+    for (auto& worker : workers) {
+        worker->executed = 0;
+        worker->steals = 0;
+        worker->busyNs = 0;
+    }
+    statsStart = std::chrono::steady_clock::now();
+}
+
+void JobSystem::logSummary() const {
+    auto stats = getStats();
+    double total = 0.0;
+    for (const auto& s : stats) {
+        total += s.utilization;
+    }
+    spdlog::info("Job system: {:.2f} of {} workers busy on average.", total, stats.size());
+    for (size_t i = 0; i < stats.size(); i++) {
+        const auto& s = stats[i];
+        spdlog::info("  worker {:>2}: {:>8} jobs, {:>6} stolen, {:5.1f}% busy", i, s.jobs, s.steals,
+                     s.utilization * 100.0);
+    }
+}
+
+}  // namespace Solaris
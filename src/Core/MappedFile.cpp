@@ -0,0 +1,94 @@
+#include "Core/MappedFile.hpp"
+
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOLARIS_HAS_MMAP 1
+#endif
+
+namespace Solaris {
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#if defined(SOLARIS_HAS_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::format("Failed to open file {}", path.string()));
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error(std::format("Failed to stat file {}", path.string()));
+    }
+
+    mSize = static_cast<size_t>(st.st_size);
+    if (mSize > 0) {
+        void* mapping = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error(std::format("Failed to map file {}", path.string()));
+        }
+        mData = static_cast<const std::byte*>(mapping);
+        mMapped = true;
+    }
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Failed to open file {}", path.string()));
+    }
+
+    mSize = static_cast<size_t>(file.tellg());
+    mFallback.resize((mSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(mFallback.data()), static_cast<std::streamsize>(mSize));
+    mData = reinterpret_cast<const std::byte*>(mFallback.data());
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mData = other.mData;
+        mSize = other.mSize;
+        mMapped = other.mMapped;
+        mFallback = std::move(other.mFallback);
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mMapped = false;
+    }
+    return *this;
+}
+
+void MappedFile::prefetch() const {
+#if defined(SOLARIS_HAS_MMAP)
+    if (mMapped) {
+        ::madvise(const_cast<std::byte*>(mData), mSize, MADV_WILLNEED);
+    }
+#endif
+}
+
+void MappedFile::close() {
+#if defined(SOLARIS_HAS_MMAP)
+    if (mMapped) {
+        ::munmap(const_cast<std::byte*>(mData), mSize);
+    }
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mMapped = false;
+    mFallback.clear();
+}
+
+}  // namespace Solaris
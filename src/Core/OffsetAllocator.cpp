@@ -0,0 +1,256 @@
+#include "Core/OffsetAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace Solaris {
+
+namespace {
+
+constexpr uint32_t mantissaBits = 3;
+constexpr uint32_t mantissaValue = 1 << mantissaBits;
+constexpr uint32_t mantissaMask = mantissaValue - 1;
+
+// Bin of the smallest size class that holds at least `size`. Used when allocating, so any region found fits.
+uint32_t binRoundUp(uint32_t size) {
+    if (size < mantissaValue) {
+        return size;
+    }
+    uint32_t highestBit = 31 - std::countl_zero(size);
+    uint32_t mantissaStart = highestBit - mantissaBits;
+    uint32_t exponent = mantissaStart + 1;
+    uint32_t mantissa = (size >> mantissaStart) & mantissaMask;
+    if ((size & ((1u << mantissaStart) - 1)) != 0) {
+        mantissa++;  // may carry into the exponent, which is still correct
+    }
+    return (exponent << mantissaBits) + mantissa;
+}
+
+// Bin of the largest size class not above `size`. Used when inserting free regions.
+uint32_t binRoundDown(uint32_t size) {
+    if (size < mantissaValue) {
+        return size;
+    }
+    uint32_t highestBit = 31 - std::countl_zero(size);
+    uint32_t mantissaStart = highestBit - mantissaBits;
+    uint32_t exponent = mantissaStart + 1;
+    uint32_t mantissa = (size >> mantissaStart) & mantissaMask;
+    return (exponent << mantissaBits) | mantissa;
+}
+
+// Index of the lowest set bit at or above `start`, or UINT32_MAX.
+uint32_t lowestBitFrom(uint32_t mask, uint32_t start) {
+    if (start >= 32) {
+        return UINT32_MAX;
+    }
+    mask &= ~((1u << start) - 1);
+    return mask == 0 ? UINT32_MAX : static_cast<uint32_t>(std::countr_zero(mask));
+}
+
+}  // namespace
+
+OffsetAllocator::OffsetAllocator(uint32_t _size, uint32_t _maxRegions) : size(_size), maxRegions(_maxRegions) {
+    reset();
+}
+
+void OffsetAllocator::reset() {
+    freeStorage = 0;
+    allocations = 0;
+    usedBinsTop = 0;
+    usedBins.fill(0);
+    binHeads.fill(kUnused);
+
+    // An empty allocator, e.g. a default constructed member, does not pay for its node pool.
+    uint32_t nodeCount = size > 0 ? maxRegions : 0;
+    nodes.assign(nodeCount, Node{});
+    freeNodes.resize(nodeCount);
+    // Popped from the back, so node 0 is handed out first.
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        freeNodes[i] = nodeCount - i - 1;
+    }
+
+    if (size > 0) {
+        insertNode(0, size);
+    }
+}
+
+OffsetAllocation OffsetAllocator::allocate(uint32_t allocSize) {
+    // A split needs a node for the remainder.
+    if (allocSize == 0 || freeNodes.empty()) {
+        return {};
+    }
+
+    uint32_t minBin = binRoundUp(allocSize);
+    uint32_t minTop = minBin >> mantissaBits;
+    uint32_t minLeaf = minBin & mantissaMask;
+
+    uint32_t top = minTop;
+    uint32_t leaf = UINT32_MAX;
+    if (top < kTopBins && (usedBinsTop & (1u << top)) != 0) {
+        leaf = lowestBitFrom(usedBins[top], minLeaf);
+    }
+    if (leaf == UINT32_MAX) {
+        // Every leaf of a larger top bin fits.
+        top = lowestBitFrom(usedBinsTop, minTop + 1);
+        if (top == UINT32_MAX) {
+            return {};
+        }
+        leaf = static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(usedBins[top])));
+    }
+
+    uint32_t bin = (top << mantissaBits) | leaf;
+    uint32_t nodeIndex = binHeads[bin];
+    Node& node = nodes[nodeIndex];
+    uint32_t regionSize = node.size;
+
+    binHeads[bin] = node.binNext;
+    if (node.binNext != kUnused) {
+        nodes[node.binNext].binPrev = kUnused;
+    }
+    if (binHeads[bin] == kUnused) {
+        usedBins[top] &= ~(1u << leaf);
+        if (usedBins[top] == 0) {
+            usedBinsTop &= ~(1u << top);
+        }
+    }
+    freeStorage -= regionSize;
+
+    node.size = allocSize;
+    node.used = true;
+    allocations++;
+    node.binNext = kUnused;
+
+    uint32_t remainder = regionSize - allocSize;
+    if (remainder > 0) {
+        uint32_t split = insertNode(node.offset + allocSize, remainder);
+        Node& rest = nodes[split];
+        rest.neighborPrev = nodeIndex;
+        rest.neighborNext = node.neighborNext;
+        if (node.neighborNext != kUnused) {
+            nodes[node.neighborNext].neighborPrev = split;
+        }
+        node.neighborNext = split;
+    }
+
+    return {node.offset, nodeIndex};
+}
+
+void OffsetAllocator::free(OffsetAllocation allocation) {
+    if (!allocation.isValid()) {
+        return;
+    }
+
+    Node& node = nodes[allocation.node];
+    assert(node.used);
+
+    uint32_t offset = node.offset;
+    uint32_t regionSize = node.size;
+
+    if (node.neighborPrev != kUnused && !nodes[node.neighborPrev].used) {
+        Node& prev = nodes[node.neighborPrev];
+        offset = prev.offset;
+        regionSize += prev.size;
+        uint32_t prevIndex = node.neighborPrev;
+        node.neighborPrev = prev.neighborPrev;
+        removeNode(prevIndex);
+    }
+    if (node.neighborNext != kUnused && !nodes[node.neighborNext].used) {
+        Node& next = nodes[node.neighborNext];
+        regionSize += next.size;
+        uint32_t nextIndex = node.neighborNext;
+        node.neighborNext = next.neighborNext;
+        removeNode(nextIndex);
+    }
+
+    uint32_t neighborPrev = node.neighborPrev;
+    uint32_t neighborNext = node.neighborNext;
+    node = Node{};
+    freeNodes.push_back(allocation.node);
+    allocations--;
+
+    uint32_t merged = insertNode(offset, regionSize);
+    nodes[merged].neighborPrev = neighborPrev;
+    nodes[merged].neighborNext = neighborNext;
+    if (neighborPrev != kUnused) {
+        nodes[neighborPrev].neighborNext = merged;
+    }
+    if (neighborNext != kUnused) {
+        nodes[neighborNext].neighborPrev = merged;
+    }
+}
+
+uint32_t OffsetAllocator::insertNode(uint32_t offset, uint32_t regionSize) {
+    uint32_t bin = binRoundDown(regionSize);
+    uint32_t top = bin >> mantissaBits;
+    uint32_t leaf = bin & mantissaMask;
+
+    if (binHeads[bin] == kUnused) {
+        usedBins[top] |= 1u << leaf;
+        usedBinsTop |= 1u << top;
+    }
+
+    uint32_t nodeIndex = freeNodes.back();
+    freeNodes.pop_back();
+
+    uint32_t head = binHeads[bin];
+    nodes[nodeIndex] = Node{offset, regionSize, kUnused, head, kUnused, kUnused, false};
+    if (head != kUnused) {
+        nodes[head].binPrev = nodeIndex;
+    }
+    binHeads[bin] = nodeIndex;
+
+    freeStorage += regionSize;
+    return nodeIndex;
+}
+
+void OffsetAllocator::removeNode(uint32_t nodeIndex) {
+    Node& node = nodes[nodeIndex];
+
+    if (node.binPrev != kUnused) {
+        nodes[node.binPrev].binNext = node.binNext;
+        if (node.binNext != kUnused) {
+            nodes[node.binNext].binPrev = node.binPrev;
+        }
+    } else {
+        uint32_t bin = binRoundDown(node.size);
+        binHeads[bin] = node.binNext;
+        if (node.binNext != kUnused) {
+            nodes[node.binNext].binPrev = kUnused;
+        }
+        if (binHeads[bin] == kUnused) {
+            uint32_t top = bin >> mantissaBits;
+            usedBins[top] &= ~(1u << (bin & mantissaMask));
+            if (usedBins[top] == 0) {
+                usedBinsTop &= ~(1u << top);
+            }
+        }
+    }
+
+    freeStorage -= node.size;
+    node = Node{};
+    freeNodes.push_back(nodeIndex);
+}
+
+uint32_t OffsetAllocator::allocationSize(OffsetAllocation allocation) const {
+    return allocation.isValid() ? nodes[allocation.node].size : 0;
+}
+
+OffsetAllocatorReport OffsetAllocator::report() const {
+    OffsetAllocatorReport result{};
+    result.totalFree = freeStorage;
+
+    if (usedBinsTop != 0) {
+        uint32_t top = 31 - std::countl_zero(usedBinsTop);
+        uint32_t leaf = 31 - std::countl_zero(static_cast<uint32_t>(usedBins[top]));
+        // The bin only bounds its regions from below, so look at the actual sizes in it.
+        for (uint32_t n = binHeads[(top << mantissaBits) | leaf]; n != kUnused; n = nodes[n].binNext) {
+            result.largestFree = std::max(result.largestFree, nodes[n].size);
+        }
+    }
+
+    result.freeRegions = static_cast<uint32_t>(nodes.size() - freeNodes.size()) - allocations;
+    return result;
+}
+
+}  // namespace Solaris
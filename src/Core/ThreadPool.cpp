@@ -0,0 +1,47 @@
+#include "Core/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace Solaris {
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+    }
+
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+
+    // Workers drain the queue before exiting, so every returned future is eventually satisfied.
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::move_only_function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace Solaris
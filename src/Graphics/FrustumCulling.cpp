@@ -0,0 +1,396 @@
+#include "Graphics/FrustumCulling.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SOLARIS_HAS_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SOLARIS_TARGET(isa)
+#else
+#define SOLARIS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace Solaris::Graphics {
+
+namespace {
+
+// Per plane: the normal, the distance, and the absolute normal for the AABB test.
+constexpr size_t kPlaneStride = 7;
+using PackedPlanes = std::array<float, 6 * kPlaneStride>;
+
+PackedPlanes packPlanes(std::span<const glm::vec4, 6> planes) {
+    PackedPlanes packed{};
+    for (size_t p = 0; p < 6; p++) {
+        float* out = &packed[p * kPlaneStride];
+        out[0] = planes[p].x;
+        out[1] = planes[p].y;
+        out[2] = planes[p].z;
+        out[3] = planes[p].w;
+        out[4] = std::abs(planes[p].x);
+        out[5] = std::abs(planes[p].y);
+        out[6] = std::abs(planes[p].z);
+    }
+    return packed;
+}
+
+// Lane indices of the set bits of every mask, to compact the visible lanes of a block with one shuffle.
+template <size_t Lanes>
+constexpr auto makeCompressTable() {
+    std::array<std::array<uint8_t, Lanes>, size_t{1} << Lanes> table{};
+    for (size_t mask = 0; mask < table.size(); mask++) {
+        size_t n = 0;
+        for (uint8_t lane = 0; lane < Lanes; lane++) {
+            if ((mask >> lane) & 1) {
+                table[mask][n++] = lane;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr auto kCompress8 = makeCompressTable<8>();
+
+// The same for four lanes as pshufb byte selectors, which SSE needs in place of a lane permute.
+constexpr auto makeCompressBytes() {
+    std::array<std::array<uint8_t, 16>, 16> table{};
+    auto lanes = makeCompressTable<4>();
+    for (size_t mask = 0; mask < table.size(); mask++) {
+        for (size_t lane = 0; lane < 4; lane++) {
+            for (uint8_t byte = 0; byte < 4; byte++) {
+                table[mask][lane * 4 + byte] = static_cast<uint8_t>(lanes[mask][lane] * 4 + byte);
+            }
+        }
+    }
+    return table;
+}
+
+constexpr auto kCompress4 = makeCompressBytes();
+
+// Every path evaluates the plane distances with the same operations in the same order as isVisibleScalar, without
+// fused multiply-adds, so they agree bit for bit even on objects that touch a plane.
+bool isVisibleScalar(const float* planes,
+                     float x,
+                     float y,
+                     float z,
+                     float radius,
+                     float bx,
+                     float by,
+                     float bz,
+                     float ex,
+                     float ey,
+                     float ez) {
+    bool straddles = false;
+    for (size_t p = 0; p < 6; p++) {
+        const float* plane = &planes[p * kPlaneStride];
+        float distance = x * plane[0] + y * plane[1] + z * plane[2] + plane[3];
+        if (distance < -radius) {
+            return false;
+        }
+        straddles = straddles || distance < radius;
+    }
+    if (!straddles) {
+        return true;
+    }
+    for (size_t p = 0; p < 6; p++) {
+        const float* plane = &planes[p * kPlaneStride];
+        float distance = bx * plane[0] + by * plane[1] + bz * plane[2] + plane[3];
+        if (distance + ex * plane[4] + ey * plane[5] + ez * plane[6] < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(SOLARIS_HAS_X86)
+
+SOLARIS_TARGET("sse4.1")
+uint32_t cullSse41(const float* const* bounds, const float* planes, uint32_t begin, uint32_t end, uint32_t* out) {
+    uint32_t written = 0;
+    for (uint32_t i = begin; i < end; i += 4) {
+        __m128 x = _mm_loadu_ps(bounds[0] + i);
+        __m128 y = _mm_loadu_ps(bounds[1] + i);
+        __m128 z = _mm_loadu_ps(bounds[2] + i);
+        __m128 radius = _mm_loadu_ps(bounds[3] + i);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+        __m128 outside = _mm_setzero_ps();
+        __m128 straddles = _mm_setzero_ps();
+        for (size_t p = 0; p < 6; p++) {
+            const float* plane = &planes[p * kPlaneStride];
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane[0])), _mm_mul_ps(y, _mm_set1_ps(plane[1])));
+            distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane[2]))), _mm_set1_ps(plane[3]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+            straddles = _mm_or_ps(straddles, _mm_cmplt_ps(distance, radius));
+        }
+
+        if (_mm_movemask_ps(_mm_andnot_ps(outside, straddles)) != 0) {
+            __m128 bx = _mm_loadu_ps(bounds[4] + i);
+            __m128 by = _mm_loadu_ps(bounds[5] + i);
+            __m128 bz = _mm_loadu_ps(bounds[6] + i);
+            __m128 ex = _mm_loadu_ps(bounds[7] + i);
+            __m128 ey = _mm_loadu_ps(bounds[8] + i);
+            __m128 ez = _mm_loadu_ps(bounds[9] + i);
+            for (size_t p = 0; p < 6; p++) {
+                const float* plane = &planes[p * kPlaneStride];
+                __m128 distance =
+                    _mm_add_ps(_mm_mul_ps(bx, _mm_set1_ps(plane[0])), _mm_mul_ps(by, _mm_set1_ps(plane[1])));
+                distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(bz, _mm_set1_ps(plane[2]))),
+                                      _mm_set1_ps(plane[3]));
+                distance = _mm_add_ps(distance, _mm_mul_ps(ex, _mm_set1_ps(plane[4])));
+                distance = _mm_add_ps(distance, _mm_mul_ps(ey, _mm_set1_ps(plane[5])));
+                distance = _mm_add_ps(distance, _mm_mul_ps(ez, _mm_set1_ps(plane[6])));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+            }
+        }
+
+        auto mask = static_cast<uint32_t>(~_mm_movemask_ps(outside) & 0xf);
+        // Shuffle the indices of the visible lanes to the front; the store may write up to three lanes past them.
+        __m128i selector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kCompress4[mask].data()));
+        __m128i indices = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)), _mm_setr_epi32(0, 1, 2, 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), _mm_shuffle_epi8(indices, selector));
+        written += static_cast<uint32_t>(std::popcount(mask));
+    }
+    return written;
+}
+
+SOLARIS_TARGET("avx2,popcnt")
+uint32_t cullAvx2(const float* const* bounds, const float* planes, uint32_t begin, uint32_t end, uint32_t* out) {
+    uint32_t written = 0;
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (uint32_t i = begin; i < end; i += 8) {
+        __m256 x = _mm256_loadu_ps(bounds[0] + i);
+        __m256 y = _mm256_loadu_ps(bounds[1] + i);
+        __m256 z = _mm256_loadu_ps(bounds[2] + i);
+        __m256 radius = _mm256_loadu_ps(bounds[3] + i);
+        __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), radius);
+
+        __m256 outside = _mm256_setzero_ps();
+        __m256 straddles = _mm256_setzero_ps();
+        for (size_t p = 0; p < 6; p++) {
+            const float* plane = &planes[p * kPlaneStride];
+            __m256 distance =
+                _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane[0])), _mm256_mul_ps(y, _mm256_set1_ps(plane[1])));
+            distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(z, _mm256_set1_ps(plane[2]))),
+                                     _mm256_set1_ps(plane[3]));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negRadius, _CMP_LT_OQ));
+            straddles = _mm256_or_ps(straddles, _mm256_cmp_ps(distance, radius, _CMP_LT_OQ));
+        }
+
+        if (_mm256_movemask_ps(_mm256_andnot_ps(outside, straddles)) != 0) {
+            __m256 bx = _mm256_loadu_ps(bounds[4] + i);
+            __m256 by = _mm256_loadu_ps(bounds[5] + i);
+            __m256 bz = _mm256_loadu_ps(bounds[6] + i);
+            __m256 ex = _mm256_loadu_ps(bounds[7] + i);
+            __m256 ey = _mm256_loadu_ps(bounds[8] + i);
+            __m256 ez = _mm256_loadu_ps(bounds[9] + i);
+            for (size_t p = 0; p < 6; p++) {
+                const float* plane = &planes[p * kPlaneStride];
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(bx, _mm256_set1_ps(plane[0])),
+                                                _mm256_mul_ps(by, _mm256_set1_ps(plane[1])));
+                distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(bz, _mm256_set1_ps(plane[2]))),
+                                         _mm256_set1_ps(plane[3]));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(ex, _mm256_set1_ps(plane[4])));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(ey, _mm256_set1_ps(plane[5])));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(ez, _mm256_set1_ps(plane[6])));
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+        }
+
+        auto mask = static_cast<uint32_t>(~_mm256_movemask_ps(outside) & 0xff);
+        // Permute the indices of the visible lanes to the front; the store may write up to seven lanes past them.
+        uint64_t lanes;
+        std::memcpy(&lanes, kCompress8[mask].data(), 8);
+        __m256i selector = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(lanes)));
+        __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), laneOffsets);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + written),
+                            _mm256_permutevar8x32_epi32(indices, selector));
+        written += static_cast<uint32_t>(std::popcount(mask));
+    }
+    return written;
+}
+
+bool cpuSupports(FrustumCuller::Path path) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::array<int, 4> info{};
+    __cpuid(info.data(), 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info.data(), 7, 0);
+    bool avx2 = osAvx && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    bool sse41 = __builtin_cpu_supports("sse4.1");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    switch (path) {
+        case FrustumCuller::Path::Avx2:
+            return avx2;
+        case FrustumCuller::Path::Sse41:
+            return sse41;
+        default:
+            return true;
+    }
+}
+
+#else
+
+bool cpuSupports(FrustumCuller::Path path) {
+    return path == FrustumCuller::Path::Scalar;
+}
+
+#endif
+
+}  // namespace
+
+FrustumCuller::Path FrustumCuller::getBestPath() {
+    for (auto path : {Path::Avx2, Path::Sse41}) {
+        if (cpuSupports(path)) {
+            return path;
+        }
+    }
+    return Path::Scalar;
+}
+
+std::string_view FrustumCuller::getPathName(Path path) {
+    switch (path) {
+        case Path::Avx2:
+            return "AVX2";
+        case Path::Sse41:
+            return "SSE4.1";
+        default:
+            return "scalar";
+    }
+}
+
+void FrustumCuller::init() {
+    init(getBestPath());
+}
+
+void FrustumCuller::init(Path _path) {
+    if (!cpuSupports(_path)) {
+        throw std::runtime_error(std::format("This CPU does not support the {} culling path", getPathName(_path)));
+    }
+    path = _path;
+}
+
+uint32_t FrustumCuller::add(const glm::vec4& sphere, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+    uint32_t object = count++;
+    uint32_t padded = (count + kBlock - 1) / kBlock * kBlock;
+    if (sphereX.size() < padded) {
+        // Padding lanes hold spheres of negative infinite radius, which every plane rejects.
+        for (auto* array : {&sphereX, &sphereY, &sphereZ, &boxX, &boxY, &boxZ, &extentX, &extentY, &extentZ}) {
+            array->resize(padded, 0.0f);
+        }
+        sphereRadius.resize(padded, -std::numeric_limits<float>::infinity());
+    }
+    set(object, sphere, boxMin, boxMax);
+    return object;
+}
+
+void FrustumCuller::set(uint32_t object, const glm::vec4& sphere, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+    sphereX[object] = sphere.x;
+    sphereY[object] = sphere.y;
+    sphereZ[object] = sphere.z;
+    sphereRadius[object] = sphere.w;
+    boxX[object] = (boxMin.x + boxMax.x) * 0.5f;
+    boxY[object] = (boxMin.y + boxMax.y) * 0.5f;
+    boxZ[object] = (boxMin.z + boxMax.z) * 0.5f;
+    extentX[object] = (boxMax.x - boxMin.x) * 0.5f;
+    extentY[object] = (boxMax.y - boxMin.y) * 0.5f;
+    extentZ[object] = (boxMax.z - boxMin.z) * 0.5f;
+}
+
+void FrustumCuller::clear() {
+    count = 0;
+    for (auto* array :
+         {&sphereX, &sphereY, &sphereZ, &sphereRadius, &boxX, &boxY, &boxZ, &extentX, &extentY, &extentZ}) {
+        array->clear();
+    }
+}
+
+void FrustumCuller::reserve(uint32_t _count) {
+    uint32_t padded = (_count + kBlock - 1) / kBlock * kBlock;
+    for (auto* array :
+         {&sphereX, &sphereY, &sphereZ, &sphereRadius, &boxX, &boxY, &boxZ, &extentX, &extentY, &extentZ}) {
+        array->reserve(padded);
+    }
+}
+
+FrustumCuller::Bounds FrustumCuller::getBounds() const {
+    return {sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data(), boxX.data(),
+            boxY.data(),    boxZ.data(),    extentX.data(), extentY.data(),      extentZ.data()};
+}
+
+uint32_t FrustumCuller::cullRange(const Bounds& bounds,
+                                  const float* planes,
+                                  uint32_t begin,
+                                  uint32_t end,
+                                  uint32_t* out) const {
+#if defined(SOLARIS_HAS_X86)
+    std::array<const float*, 10> arrays{bounds.sphereX, bounds.sphereY, bounds.sphereZ, bounds.sphereRadius,
+                                        bounds.boxX,    bounds.boxY,    bounds.boxZ,    bounds.extentX,
+                                        bounds.extentY, bounds.extentZ};
+    if (path == Path::Avx2) {
+        return cullAvx2(arrays.data(), planes, begin, end, out);
+    }
+    if (path == Path::Sse41) {
+        return cullSse41(arrays.data(), planes, begin, end, out);
+    }
+#endif
+
+    uint32_t written = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        // Branch-free append, the index is overwritten by the next one when invisible.
+        out[written] = i;
+        written += isVisibleScalar(planes, bounds.sphereX[i], bounds.sphereY[i], bounds.sphereZ[i],
+                                   bounds.sphereRadius[i], bounds.boxX[i], bounds.boxY[i], bounds.boxZ[i],
+                                   bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i])
+                       ? 1
+                       : 0;
+    }
+    return written;
+}
+
+void FrustumCuller::cull(std::span<const glm::vec4, 6> planes, std::vector<uint32_t>& visible, JobSystem* jobs) {
+    auto packed = packPlanes(planes);
+    auto bounds = getBounds();
+    uint32_t padded = static_cast<uint32_t>(sphereX.size());
+
+    // Each chunk writes to its own part of the scratch buffer, then the parts are packed in order. Culling straight
+    // into `visible` would mean zero-filling it to the object count first.
+    uint32_t chunks = (padded + kChunk - 1) / kChunk;
+    scratch.resize(padded + size_t{chunks} * kBlock);
+    chunkCounts.resize(chunks);
+    if (jobs == nullptr || chunks == 1) {
+        chunkCounts.assign(1, cullRange(bounds, packed.data(), 0, padded, scratch.data()));
+        visible.assign(scratch.begin(), scratch.begin() + chunkCounts[0]);
+        return;
+    }
+
+    jobs->parallelFor(chunks, 1, [&](uint32_t first, uint32_t last) {
+        for (uint32_t chunk = first; chunk < last; chunk++) {
+            uint32_t begin = chunk * kChunk;
+            uint32_t end = std::min(padded, begin + kChunk);
+            chunkCounts[chunk] =
+                cullRange(bounds, packed.data(), begin, end, scratch.data() + begin + size_t{chunk} * kBlock);
+        }
+    });
+
+    visible.clear();
+    for (uint32_t chunk = 0; chunk < chunks; chunk++) {
+        const uint32_t* part = scratch.data() + size_t{chunk} * kChunk + size_t{chunk} * kBlock;
+        visible.insert(visible.end(), part, part + chunkCounts[chunk]);
+    }
+}
+
+}  // namespace Solaris::Graphics
@@ -0,0 +1,104 @@
+#include "Graphics/LodSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+namespace Solaris::Graphics {
+
+namespace {
+
+// Below this many objects a batch costs more to schedule than to run.
+constexpr uint32_t kMinBatch = 4096;
+
+}  // namespace
+
+void LodSelector::init(const Config& _config) {
+    config = _config;
+}
+
+uint32_t LodSelector::addMesh(std::span<const MeshLod> meshLods) {
+    if (meshLods.empty() || meshLods.size() > kMaxMeshLods) {
+        throw std::runtime_error(std::format("A mesh needs 1 to {} levels of detail, not {}", kMaxMeshLods,
+                                             meshLods.size()));
+    }
+    Chain entry{};
+    for (const auto& lod : meshLods) {
+        entry.errors[entry.count++] = lod.error;
+    }
+    chains.push_back(entry);
+    return static_cast<uint32_t>(chains.size() - 1);
+}
+
+uint32_t LodSelector::addObject(uint32_t mesh, const glm::vec3& center, float _radius, float _scale) {
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(_radius);
+    scale.push_back(_scale);
+    chain.push_back(mesh);
+    lods.push_back(0);
+    changedFlags.push_back(0);
+    return static_cast<uint32_t>(lods.size() - 1);
+}
+
+void LodSelector::setBounds(uint32_t object, const glm::vec3& center, float _radius) {
+    centerX[object] = center.x;
+    centerY[object] = center.y;
+    centerZ[object] = center.z;
+    radius[object] = _radius;
+}
+
+void LodSelector::select(const glm::vec3& camera, float projectionScale, JobSystem* jobs) {
+    auto count = static_cast<uint32_t>(lods.size());
+    if (jobs != nullptr && count > kMinBatch) {
+        jobs->parallelFor(count, kMinBatch, [&](uint32_t begin, uint32_t end) {
+            selectRange(begin, end, camera, projectionScale);
+        });
+    } else {
+        selectRange(0, count, camera, projectionScale);
+    }
+
+    changed.clear();
+    for (uint32_t i = 0; i < count; i++) {
+        if (changedFlags[i] != 0) {
+            changed.push_back(i);
+        }
+    }
+}
+
+void LodSelector::selectRange(uint32_t begin, uint32_t end, const glm::vec3& camera, float projectionScale) {
+    float coarsenFactor = 1.0f - config.hysteresis;
+    for (uint32_t i = begin; i < end; i++) {
+        float dx = centerX[i] - camera.x;
+        float dy = centerY[i] - camera.y;
+        float dz = centerZ[i] - camera.z;
+        float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - radius[i];
+
+        const auto& levels = chains[chain[i]];
+        uint32_t current = lods[i];
+        uint32_t next = 0;
+        if (distance > 0.0f) {
+            // The largest object-space error that still projects to at most pixelError.
+            float limit = config.pixelError * distance / (projectionScale * scale[i]);
+            if (levels.errors[current] > limit) {
+                next = current;
+                while (next > 0 && levels.errors[next] > limit) {
+                    next--;
+                }
+            } else {
+                float coarsen = limit * coarsenFactor;
+                next = current;
+                while (next + 1 < levels.count && levels.errors[next + 1] <= coarsen) {
+                    next++;
+                }
+            }
+        }
+
+        changedFlags[i] = next != current ? 1 : 0;
+        lods[i] = static_cast<uint8_t>(next);
+    }
+}
+
+}  // namespace Solaris::Graphics
@@ -0,0 +1,152 @@
+#include "Graphics/MeshFile.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+namespace Solaris::Graphics {
+
+namespace {
+
+template <typename T>
+std::span<const std::byte> asBytes(const std::vector<T>& values) {
+    return std::as_bytes(std::span(values));
+}
+
+}  // namespace
+
+void WriteMeshFile(const std::filesystem::path& path, const MeshData& mesh) {
+    if (mesh.streams.size() != mesh.streamStrides.size()) {
+        throw std::runtime_error("Mesh has a different number of vertex streams and strides");
+    }
+
+    MeshFileHeader header{};
+    header.vertexCount = mesh.vertexCount;
+    header.indexSize = mesh.indexSize;
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size() / mesh.indexSize);
+    header.bounds = mesh.bounds;
+
+    // Lay out every section on an aligned offset after the header, then write them in the same order.
+    std::vector<std::span<const std::byte>> blobs;
+    uint64_t offset = sizeof(MeshFileHeader);
+    auto place = [&](std::span<const std::byte> blob) {
+        offset = (offset + kMeshAlignment - 1) / kMeshAlignment * kMeshAlignment;
+        MeshSectionRange range{offset, blob.size()};
+        blobs.push_back(blob);
+        offset += blob.size();
+        return range;
+    };
+
+    std::vector<MeshStream> streams(mesh.streams.size());
+    for (size_t i = 0; i < mesh.streams.size(); i++) {
+        auto range = place(std::span(mesh.streams[i]));
+        streams[i] = {mesh.streamStrides[i], 0, range.offset, range.size};
+    }
+
+    auto& sections = header.sections;
+    sections[static_cast<size_t>(MeshSection::Attributes)] = place(asBytes(mesh.attributes));
+    sections[static_cast<size_t>(MeshSection::Streams)] = place(asBytes(streams));
+    sections[static_cast<size_t>(MeshSection::Indices)] = place(std::span(mesh.indices));
+    sections[static_cast<size_t>(MeshSection::Lods)] = place(asBytes(mesh.lods));
+    sections[static_cast<size_t>(MeshSection::Meshlets)] = place(asBytes(mesh.meshlets));
+    sections[static_cast<size_t>(MeshSection::MeshletVertices)] = place(asBytes(mesh.meshletVertices));
+    sections[static_cast<size_t>(MeshSection::MeshletTriangles)] = place(asBytes(mesh.meshletTriangles));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error(std::format("Failed to create mesh file {}", path.string()));
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    uint64_t written = sizeof(header);
+    const char padding[kMeshAlignment]{};
+    for (auto blob : blobs) {
+        uint64_t aligned = (written + kMeshAlignment - 1) / kMeshAlignment * kMeshAlignment;
+        file.write(padding, static_cast<std::streamsize>(aligned - written));
+        file.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+        written = aligned + blob.size();
+    }
+
+    if (!file) {
+        throw std::runtime_error(std::format("Failed to write mesh file {}", path.string()));
+    }
+}
+
+MeshFile::MeshFile(const std::filesystem::path& path) : mFile(path) {
+    if (mFile.size() < sizeof(MeshFileHeader)) {
+        throw std::runtime_error(std::format("{} is not a mesh file", path.string()));
+    }
+    pHeader = reinterpret_cast<const MeshFileHeader*>(mFile.data());
+    if (pHeader->magic != kMeshMagic) {
+        throw std::runtime_error(std::format("{} is not a mesh file", path.string()));
+    }
+    if (pHeader->version != kMeshVersion) {
+        throw std::runtime_error(std::format("{} is mesh version {}, expected {}; convert it again", path.string(),
+                                             pHeader->version, kMeshVersion));
+    }
+    if (pHeader->indexSize != 1 && pHeader->indexSize != 2 && pHeader->indexSize != 4) {
+        throw std::runtime_error(std::format("{} has an unsupported index size of {}", path.string(),
+                                             pHeader->indexSize));
+    }
+
+    auto inFile = [&](uint64_t offset, uint64_t size) {
+        return offset % kMeshAlignment == 0 && offset <= mFile.size() && size <= mFile.size() - offset;
+    };
+    for (const auto& range : pHeader->sections) {
+        if (!inFile(range.offset, range.size)) {
+            throw std::runtime_error(std::format("{} is truncated or has a misaligned section", path.string()));
+        }
+    }
+    for (const auto& stream : streams()) {
+        if (!inFile(stream.offset, stream.size) || stream.size != uint64_t{stream.stride} * vertexCount()) {
+            throw std::runtime_error(std::format("{} has a malformed vertex stream", path.string()));
+        }
+    }
+    if (bytes(MeshSection::Indices).size() != uint64_t{indexCount()} * indexSize()) {
+        throw std::runtime_error(std::format("{} has a malformed index stream", path.string()));
+    }
+    if (lods().size() > kMaxMeshLods) {
+        throw std::runtime_error(std::format("{} has more than {} levels of detail", path.string(), kMaxMeshLods));
+    }
+    for (const auto& lod : lods()) {
+        if (uint64_t{lod.firstIndex} + lod.indexCount > indexCount()) {
+            throw std::runtime_error(std::format("{} has a level of detail past the index stream", path.string()));
+        }
+    }
+    for (const auto& attribute : attributes()) {
+        if (attribute.stream >= streams().size()) {
+            throw std::runtime_error(std::format("{} has an attribute in a missing vertex stream", path.string()));
+        }
+    }
+
+    auto vertices = meshletVertices();
+    auto triangles = meshletTriangles();
+    for (const auto& meshlet : meshlets()) {
+        if (meshlet.vertexCount > kMaxMeshletVertices || meshlet.triangleCount > kMaxMeshletTriangles ||
+            uint64_t{meshlet.vertexOffset} + meshlet.vertexCount > vertices.size() ||
+            uint64_t{meshlet.triangleOffset} + 3 * uint64_t{meshlet.triangleCount} > triangles.size()) {
+            throw std::runtime_error(std::format("{} has a meshlet past its vertex or triangle section",
+                                                 path.string()));
+        }
+        auto local = triangles.subspan(meshlet.triangleOffset, 3 * meshlet.triangleCount);
+        if (std::ranges::any_of(local, [&](uint8_t corner) { return corner >= meshlet.vertexCount; })) {
+            throw std::runtime_error(std::format("{} has a meshlet triangle past the meshlet's vertices",
+                                                 path.string()));
+        }
+    }
+    if (std::ranges::any_of(vertices, [&](uint32_t vertex) { return vertex >= vertexCount(); })) {
+        throw std::runtime_error(std::format("{} has a meshlet vertex past the vertex streams", path.string()));
+    }
+}
+
+std::span<const std::byte> MeshFile::bytes(MeshSection section) const {
+    const auto& range = pHeader->sections[static_cast<size_t>(section)];
+    return mFile.bytes().subspan(range.offset, range.size);
+}
+
+std::span<const std::byte> MeshFile::streamBytes(uint32_t stream) const {
+    const auto& range = streams()[stream];
+    return mFile.bytes().subspan(range.offset, range.size);
+}
+
+}  // namespace Solaris::Graphics
@@ -0,0 +1,633 @@
+#include "Graphics/MeshProcessing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <string_view>
+#include <unordered_map>
+
+namespace Solaris::Graphics {
+
+namespace {
+
+struct Sphere {
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+};
+
+// Sphere around the AABB centre; loose, but cheap and stable.
+template <typename Positions>
+Sphere boundingSphere(const Positions& positions, glm::vec3& min, glm::vec3& max) {
+    min = glm::vec3(std::numeric_limits<float>::max());
+    max = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const glm::vec3& p : positions) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    Sphere sphere{(min + max) * 0.5f, 0.0f};
+    for (const glm::vec3& p : positions) {
+        sphere.radius = std::max(sphere.radius, glm::length(p - sphere.center));
+    }
+    return sphere;
+}
+
+}  // namespace
+
+MeshBounds ComputeBounds(std::span<const glm::vec3> positions) {
+    MeshBounds bounds{};
+    if (positions.empty()) {
+        return bounds;
+    }
+
+    glm::vec3 min, max;
+    auto sphere = boundingSphere(positions, min, max);
+    bounds.min = {min.x, min.y, min.z};
+    bounds.max = {max.x, max.y, max.z};
+    bounds.center = {sphere.center.x, sphere.center.y, sphere.center.z};
+    bounds.radius = sphere.radius;
+    return bounds;
+}
+
+MeshletBuild BuildMeshlets(std::span<const uint32_t> indices, std::span<const glm::vec3> positions) {
+    constexpr uint32_t kUnused = std::numeric_limits<uint32_t>::max();
+
+    MeshletBuild build{};
+    std::vector<uint32_t> local(positions.size(), kUnused);  // meshlet vertex of each mesh vertex
+    Meshlet current{};
+
+    auto finish = [&] {
+        if (current.triangleCount == 0) {
+            return;
+        }
+        auto vertices = std::span(build.vertices).subspan(current.vertexOffset, current.vertexCount);
+        glm::vec3 min, max;
+        auto sphere = boundingSphere(vertices | std::views::transform([&](uint32_t v) { return positions[v]; }),
+                                     min, max);
+        current.center = {sphere.center.x, sphere.center.y, sphere.center.z};
+        current.radius = sphere.radius;
+        build.meshlets.push_back(current);
+
+        for (auto v : vertices) {
+            local[v] = kUnused;
+        }
+        current = {};
+        current.vertexOffset = static_cast<uint32_t>(build.vertices.size());
+        current.triangleOffset = static_cast<uint32_t>(build.triangles.size());
+    };
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        uint32_t added = 0;
+        for (size_t c = 0; c < 3; c++) {
+            added += local[indices[i + c]] == kUnused ? 1 : 0;
+        }
+        if (current.vertexCount + added > kMaxMeshletVertices || current.triangleCount + 1 > kMaxMeshletTriangles) {
+            finish();
+        }
+
+        for (size_t c = 0; c < 3; c++) {
+            uint32_t v = indices[i + c];
+            if (local[v] == kUnused) {
+                local[v] = current.vertexCount++;
+                build.vertices.push_back(v);
+            }
+            build.triangles.push_back(static_cast<uint8_t>(local[v]));
+        }
+        current.triangleCount++;
+    }
+    finish();
+    return build;
+}
+
+VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize) {
+    // Time each vertex entered the cache; it is still there while fewer than cacheSize misses have happened since.
+    std::vector<uint32_t> entered(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+
+    VertexCacheStats stats{};
+    for (uint32_t index : indices) {
+        if (time - entered[index] > cacheSize) {
+            entered[index] = time++;
+            stats.misses++;
+        }
+    }
+    size_t triangles = indices.size() / 3;
+    stats.acmr = triangles > 0 ? static_cast<float>(stats.misses) / static_cast<float>(triangles) : 0.0f;
+    stats.atvr = vertexCount > 0 ? static_cast<float>(stats.misses) / static_cast<float>(vertexCount) : 0.0f;
+    return stats;
+}
+
+VertexRemap DeduplicateVertices(std::span<const std::byte> vertices, uint32_t stride) {
+    size_t count = vertices.size() / stride;
+    VertexRemap result{};
+    result.remap.resize(count);
+
+    std::unordered_map<std::string_view, uint32_t> unique;
+    unique.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        std::string_view key(reinterpret_cast<const char*>(vertices.data() + i * stride), stride);
+        auto [it, inserted] = unique.try_emplace(key, result.vertexCount);
+        if (inserted) {
+            result.vertexCount++;
+        }
+        result.remap[i] = it->second;
+    }
+    return result;
+}
+
+namespace {
+
+constexpr int32_t kForsythCacheSize = 32;
+
+float forsythScore(int32_t cachePosition, uint32_t remaining) {
+    if (remaining == 0) {
+        return -1.0f;
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // The last triangle's vertices score a fixed amount lower, so that it is not simply extended into a strip.
+        score = cachePosition < 3 ? 0.75f
+                                  : std::pow(1.0f - static_cast<float>(cachePosition - 3) /
+                                                        static_cast<float>(kForsythCacheSize - 3),
+                                             1.5f);
+    }
+    // Finishing off vertices with few triangles left frees cache entries.
+    return score + 2.0f / std::sqrt(static_cast<float>(remaining));
+}
+
+}  // namespace
+
+void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount) {
+    constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // Triangles using each vertex, the first `remaining[v]` of a vertex's range are the ones not emitted yet.
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < size_t{triangleCount} * 3; i++) {
+        remaining[indices[i]]++;
+    }
+    std::vector<uint32_t> first(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        first[v + 1] = first[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(first[vertexCount]);
+    std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            adjacency[fill[indices[t * 3 + c]]++] = t;
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = forsythScore(-1, remaining[v]);
+    }
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    uint32_t best = 0;
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+        best = triangleScore[t] > triangleScore[best] ? t : best;
+    }
+
+    std::vector<uint32_t> output;
+    output.reserve(size_t{triangleCount} * 3);
+    std::array<uint32_t, kForsythCacheSize + 3> cache{};
+    std::array<uint32_t, kForsythCacheSize + 3> next{};
+    size_t cacheCount = 0;
+    uint32_t cursor = 0;
+
+    while (output.size() < size_t{triangleCount} * 3) {
+        if (best == kNone) {
+            // Nothing in the cache has triangles left, continue with the next one in the input order.
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = cursor;
+        }
+
+        std::array<uint32_t, 3> triangle{indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2]};
+        emitted[best] = true;
+        output.insert(output.end(), triangle.begin(), triangle.end());
+
+        for (uint32_t v : triangle) {
+            auto begin = adjacency.begin() + first[v];
+            auto end = begin + remaining[v];
+            auto it = std::find(begin, end, best);
+            if (it != end) {
+                std::iter_swap(it, end - 1);
+                remaining[v]--;
+            }
+        }
+
+        // The triangle's vertices move to the front, the rest shift back and may fall out.
+        size_t nextCount = 0;
+        for (uint32_t v : triangle) {
+            if (std::find(next.begin(), next.begin() + nextCount, v) == next.begin() + nextCount) {
+                next[nextCount++] = v;
+            }
+        }
+        for (size_t i = 0; i < cacheCount; i++) {
+            if (std::ranges::find(triangle, cache[i]) == triangle.end()) {
+                next[nextCount++] = cache[i];
+            }
+        }
+
+        for (size_t i = 0; i < nextCount; i++) {
+            uint32_t v = next[i];
+            cachePosition[v] = i < kForsythCacheSize ? static_cast<int32_t>(i) : -1;
+            float score = forsythScore(cachePosition[v], remaining[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            for (uint32_t a = first[v]; a < first[v] + remaining[v]; a++) {
+                triangleScore[adjacency[a]] += delta;
+            }
+        }
+
+        best = kNone;
+        float bestScore = -1.0f;
+        cacheCount = std::min<size_t>(nextCount, kForsythCacheSize);
+        for (size_t i = 0; i < cacheCount; i++) {
+            uint32_t v = next[i];
+            cache[i] = v;
+            for (uint32_t a = first[v]; a < first[v] + remaining[v]; a++) {
+                if (triangleScore[adjacency[a]] > bestScore) {
+                    bestScore = triangleScore[adjacency[a]];
+                    best = adjacency[a];
+                }
+            }
+        }
+    }
+
+    std::ranges::copy(output, indices.begin());
+}
+
+VertexRemap OptimizeVertexFetch(std::span<const uint32_t> indices, uint32_t vertexCount) {
+    VertexRemap result{};
+    result.remap.assign(vertexCount, VertexRemap::kUnusedVertex);
+    for (uint32_t index : indices) {
+        if (result.remap[index] == VertexRemap::kUnusedVertex) {
+            result.remap[index] = result.vertexCount++;
+        }
+    }
+    return result;
+}
+
+void RemapIndices(std::span<uint32_t> indices, const VertexRemap& remap) {
+    for (auto& index : indices) {
+        index = remap.remap[index];
+    }
+}
+
+namespace {
+
+// Weighted sum of squared distances to a set of planes, as the upper triangle of a symmetric 4x4 matrix.
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+    double weight = 0;
+
+    static Quadric fromPlane(double a, double b, double c, double d, double w) {
+        return {w * a * a, w * a * b, w * a * c, w * a * d, w * b * b, w * b * c, w * b * d, w * c * c,
+                w * c * d, w * d * d, w};
+    }
+
+    Quadric& operator+=(const Quadric& o) {
+        a2 += o.a2, ab += o.ab, ac += o.ac, ad += o.ad, b2 += o.b2;
+        bc += o.bc, bd += o.bd, c2 += o.c2, cd += o.cd, d2 += o.d2;
+        weight += o.weight;
+        return *this;
+    }
+
+    // Mean squared distance of `p` to the planes.
+    [[nodiscard]] double evaluate(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double value = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x + b2 * y * y + 2 * bc * y * z +
+                       2 * bd * y + c2 * z * z + 2 * cd * z + d2;
+        return weight > 0 ? std::max(value, 0.0) / weight : 0.0;
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double error;
+};
+
+// Whether moving `from` onto `to` turns any of its triangles, other than those it shares with `to`, over.
+bool flipsTriangle(uint32_t from,
+                   uint32_t to,
+                   std::span<const uint32_t> indices,
+                   std::span<const uint32_t> triangles,
+                   std::span<const glm::vec3> positions) {
+    for (uint32_t t : triangles) {
+        std::array<uint32_t, 3> corners{indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+        if (std::ranges::find(corners, to) != corners.end()) {
+            continue;  // becomes degenerate and disappears
+        }
+        glm::vec3 before = glm::cross(positions[corners[1]] - positions[corners[0]],
+                                      positions[corners[2]] - positions[corners[0]]);
+        for (auto& corner : corners) {
+            corner = corner == from ? to : corner;
+        }
+        glm::vec3 after = glm::cross(positions[corners[1]] - positions[corners[0]],
+                                     positions[corners[2]] - positions[corners[0]]);
+        if (glm::dot(before, after) <= 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Closest point of triangle abc to p, from Ericson, Real-Time Collision Detection, 5.1.5.
+glm::vec3 closestOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ap = p - a;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return a;
+    }
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp);
+    float d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return b;
+    }
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        return a + ab * (d1 / (d1 - d3));
+    }
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp);
+    float d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return c;
+    }
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        return a + ac * (d2 / (d2 - d6));
+    }
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// Updates each input vertex's distance to the simplified triangles within two rings of the vertex it was collapsed
+// into and returns the largest. Simplified vertices are input vertices, so this is the deviation in both
+// directions at the vertices. Searching only near the proxy can overestimate the distance to the nearest triangle
+// but never underestimate it. Only vertices whose proxy or one of its neighbours was `touched` are measured again,
+// the triangles near any other proxy are unchanged. The search for a vertex stops once it is within `known`, the
+// previous result, since it can no longer raise the maximum; its entry then stays an upper bound. A vertex whose
+// proxy has no triangles left is measured against the nearest vertex that has some, on every pass; with none left
+// its deviation is infinite, which no error limit accepts.
+float updateDeviation(std::span<const uint32_t> indices,
+                      std::span<const glm::vec3> positions,
+                      std::span<const uint32_t> proxies,
+                      const std::vector<bool>& touched,
+                      float known,
+                      std::span<float> deviations) {
+    auto vertexCount = static_cast<uint32_t>(positions.size());
+    std::vector<uint32_t> first(vertexCount + 1, 0);
+    for (uint32_t v : indices) {
+        first[v + 1]++;
+    }
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        first[v + 1] += first[v];
+    }
+    std::vector<uint32_t> triangles(indices.size());
+    std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+        triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        uint32_t proxy = proxies[v];
+        if (proxy == v) {
+            continue;  // still in place, on its own triangles
+        }
+        const auto& p = positions[v];
+        if (first[proxy] == first[proxy + 1]) {
+            // The proxy lost all its triangles. A surviving vertex lies on the surface, so the distance to the
+            // nearest one still bounds the deviation; without any the level has no surface left to measure.
+            float nearest = std::numeric_limits<float>::infinity();
+            for (uint32_t u = 0; u < vertexCount && nearest > known; u++) {
+                if (first[u] != first[u + 1]) {
+                    nearest = std::min(nearest, glm::distance(p, positions[u]));
+                }
+            }
+            deviations[v] = nearest;
+            continue;
+        }
+        bool changed = touched[proxy];
+        for (uint32_t i = first[proxy]; i < first[proxy + 1] && !changed; i++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                changed = changed || touched[indices[triangles[i] * 3 + c]];
+            }
+        }
+        if (!changed) {
+            continue;
+        }
+
+        float nearest = std::numeric_limits<float>::max();
+        auto search = [&](uint32_t vertex) {
+            for (uint32_t i = first[vertex]; i < first[vertex + 1] && nearest > known; i++) {
+                uint32_t t = triangles[i];
+                auto closest = closestOnTriangle(p, positions[indices[t * 3]], positions[indices[t * 3 + 1]],
+                                                 positions[indices[t * 3 + 2]]);
+                nearest = std::min(nearest, glm::distance(p, closest));
+            }
+        };
+        // The proxy's own triangles first, they are the most likely to be nearest.
+        search(proxy);
+        for (uint32_t i = first[proxy]; i < first[proxy + 1] && nearest > known; i++) {
+            for (uint32_t c = 0; c < 3; c++) {
+                search(indices[triangles[i] * 3 + c]);
+            }
+        }
+        deviations[v] = nearest;
+    }
+    return std::ranges::max(deviations);
+}
+
+}  // namespace
+
+SimplifyResult SimplifyMesh(std::span<const uint32_t> indices,
+                            std::span<const glm::vec3> positions,
+                            size_t targetIndexCount,
+                            float maxError) {
+    auto vertexCount = static_cast<uint32_t>(positions.size());
+    SimplifyResult result{{indices.begin(), indices.end()}, 0.0f};
+
+    // Seams: several vertices sharing a position, which differ in normal or texture coordinate.
+    std::vector<bool> locked(vertexCount, false);
+    {
+        std::unordered_map<std::string_view, uint32_t> first;
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            std::string_view key(reinterpret_cast<const char*>(&positions[v]), sizeof(glm::vec3));
+            auto [it, inserted] = first.try_emplace(key, v);
+            if (!inserted) {
+                locked[v] = true;
+                locked[it->second] = true;
+            }
+        }
+    }
+
+    // Borders: edges of only one triangle. An edge and its reverse count as the same edge.
+    std::unordered_map<uint64_t, uint32_t> edgeUse;
+    auto edgeKey = [](uint32_t a, uint32_t b) { return (uint64_t{std::min(a, b)} << 32) | std::max(a, b); };
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        for (size_t c = 0; c < 3; c++) {
+            edgeUse[edgeKey(indices[i + c], indices[i + (c + 1) % 3])]++;
+        }
+    }
+    for (const auto& [key, count] : edgeUse) {
+        if (count == 1) {
+            locked[static_cast<uint32_t>(key >> 32)] = true;
+            locked[static_cast<uint32_t>(key)] = true;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const auto& p0 = positions[indices[i]];
+        glm::vec3 normal = glm::cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+        float area = glm::length(normal);
+        if (area == 0.0f) {
+            continue;
+        }
+        normal = normal / area;
+        // Weighted by area, so that a few small triangles do not dominate a large flat one.
+        auto plane = Quadric::fromPlane(normal.x, normal.y, normal.z, -glm::dot(normal, p0), area * 0.5);
+        for (size_t c = 0; c < 3; c++) {
+            quadrics[indices[i + c]] += plane;
+        }
+    }
+
+    double maxErrorSquared = double{maxError} * maxError;
+    std::vector<uint32_t> proxies(vertexCount);  // the vertex each input vertex has been collapsed into
+    std::iota(proxies.begin(), proxies.end(), 0u);
+    std::vector<float> deviations(vertexCount, 0.0f);
+    std::vector<uint32_t> previous;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> triangleFirst(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+
+    auto& current = result.indices;
+    while (current.size() > targetIndexCount) {
+        // Triangles of each vertex, for the flip test.
+        std::ranges::fill(triangleFirst, 0);
+        for (uint32_t v : current) {
+            triangleFirst[v + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            triangleFirst[v + 1] += triangleFirst[v];
+        }
+        adjacency.resize(current.size());
+        std::vector<uint32_t> fill(triangleFirst.begin(), triangleFirst.end() - 1);
+        for (size_t i = 0; i < current.size(); i++) {
+            adjacency[fill[current[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+        auto trianglesOf = [&](uint32_t v) {
+            return std::span(adjacency).subspan(triangleFirst[v], triangleFirst[v + 1] - triangleFirst[v]);
+        };
+
+        // Every edge once, in its cheaper direction.
+        collapses.clear();
+        for (size_t i = 0; i + 2 < current.size(); i += 3) {
+            for (size_t c = 0; c < 3; c++) {
+                uint32_t a = current[i + c];
+                uint32_t b = current[i + (c + 1) % 3];
+                if (a > b) {
+                    // Interior edges appear twice, once each way. Border edges have both ends locked.
+                    continue;
+                }
+                Quadric q = quadrics[a];
+                q += quadrics[b];
+                double toB = locked[a] ? std::numeric_limits<double>::max() : q.evaluate(positions[b]);
+                double toA = locked[b] ? std::numeric_limits<double>::max() : q.evaluate(positions[a]);
+                if (std::min(toA, toB) <= maxErrorSquared) {
+                    collapses.push_back(toB <= toA ? Collapse{a, b, toB} : Collapse{b, a, toA});
+                }
+            }
+        }
+        if (collapses.empty()) {
+            break;
+        }
+        std::ranges::sort(collapses, {}, &Collapse::error);
+
+        // Cheapest first, each vertex in at most one collapse per pass so the flip tests stay valid. Each collapse
+        // removes about two triangles.
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            remap[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+        size_t goal = (current.size() - targetIndexCount) / 6 + 1;
+        size_t applied = 0;
+        for (const auto& collapse : collapses) {
+            if (applied >= goal) {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to] ||
+                flipsTriangle(collapse.from, collapse.to, current, trianglesOf(collapse.from), positions)) {
+                continue;
+            }
+            for (uint32_t t : trianglesOf(collapse.from)) {
+                for (size_t c = 0; c < 3; c++) {
+                    touched[current[t * 3 + c]] = true;
+                }
+            }
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            applied++;
+        }
+        if (applied == 0) {
+            break;
+        }
+
+        previous.assign(current.begin(), current.end());
+        size_t kept = 0;
+        for (size_t i = 0; i + 2 < current.size(); i += 3) {
+            uint32_t a = remap[current[i]];
+            uint32_t b = remap[current[i + 1]];
+            uint32_t c = remap[current[i + 2]];
+            if (a != b && b != c && a != c) {
+                current[kept++] = a;
+                current[kept++] = b;
+                current[kept++] = c;
+            }
+        }
+        current.resize(kept);
+
+        // The quadrics are area-weighted means over many planes and underestimate how far the surface moved,
+        // so the error reported and checked against maxError is measured on the result. A pass that goes past
+        // the limit is undone.
+        for (auto& proxy : proxies) {
+            proxy = remap[proxy];
+        }
+        float deviation = updateDeviation(current, positions, proxies, touched, result.error, deviations);
+        if (deviation > maxError) {
+            current.swap(previous);
+            break;
+        }
+        result.error = deviation;
+    }
+
+    return result;
+}
+
+}  // namespace Solaris::Graphics
@@ -1,4 +1,6 @@
 #include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/Allocator.hpp"
+#include "Graphics/Vulkan/Upload.hpp"
 
 #include <cstdint>
 #include <vulkan/vulkan.hpp>
@@ -7,20 +9,22 @@
 #include <vulkan/vulkan_structs.hpp>
 
 #include <cstring>
+#include <format>
+#include <stdexcept>
 
 namespace Solaris::Graphics::Vulkan {
 
 void Buffer::init(vma::Allocator* _allocator,
-                  vk::DeviceSize size,
-                  vk::BufferUsageFlags usage,
+                  vk::DeviceSize _size,
+                  vk::BufferUsageFlags _usage,
                   bool hostVisible,
-                  bool deviceLocal) {
+                  bool deviceLocal,
+                  MemoryCategory _category) {
     allocator = _allocator;
-
-    vk::BufferCreateInfo bufferInfo{};
-    bufferInfo.setSize(size);
-    bufferInfo.setUsage(usage);
-    bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
+    size = _size;
+    usage = _usage;
+    category = _category;
+    relocatable = false;
 
     vma::AllocationCreateInfo allocCreateInfo{};
     if (deviceLocal) {
@@ -33,75 +37,88 @@ void Buffer::init(vma::Allocator* _allocator,
         allocCreateInfo.flags =
             vma::AllocationCreateFlagBits::eHostAccessSequentialWrite | vma::AllocationCreateFlagBits::eMapped;
     }
+    create(allocCreateInfo);
+}
+
+void Buffer::initRelocatable(vma::Allocator* _allocator,
+                             vma::Pool pool,
+                             vk::DeviceSize _size,
+                             vk::BufferUsageFlags _usage,
+                             MemoryCategory _category) {
+    if (!pool) {
+        throw std::runtime_error("Relocatable buffers need the allocator's relocatable pool");
+    }
+    if (_usage & ~kRelocatableBufferUsage) {
+        throw std::runtime_error(std::format("Buffer usage {} is not supported by the relocatable pool",
+                                             vk::to_string(_usage)));
+    }
+    allocator = _allocator;
+    size = _size;
+    usage = _usage;
+    category = _category;
+    relocatable = true;
+
+    vma::AllocationCreateInfo allocCreateInfo{};
+    allocCreateInfo.pool = pool;
+    create(allocCreateInfo);
+}
+
+void Buffer::create(const vma::AllocationCreateInfo& allocCreateInfo) {
+    vk::BufferCreateInfo bufferInfo{};
+    bufferInfo.setSize(size);
+    bufferInfo.setUsage(usage);
+    bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
 
     auto [buffer, alloc] = allocator->createBuffer(bufferInfo, allocCreateInfo, allocInfo);
     _buffer = buffer;
     allocation = alloc;
+    trackAllocation(*allocator, allocation, category, allocInfo.size);
+    allocator->setAllocationUserData(allocation, this);
 }
 
 void Buffer::destroy() {
     if (_buffer) {
-        allocator->destroyBuffer(_buffer, allocation);
+        untrackAllocation(category, allocInfo.size);
+        if (relocating) {
+            // VMA frees the allocation when the defragmentation pass ends and finds no owner.
+            allocator->destroyBuffer(_buffer, nullptr);
+            allocator->setAllocationUserData(allocation, nullptr);
+            relocating = false;
+        } else {
+            allocator->destroyBuffer(_buffer, allocation);
+        }
         _buffer = VK_NULL_HANDLE;
         allocation = nullptr;
     }
 }
 
-void Buffer::copy(Buffer& src,
-                  Buffer& dst,
-                  vk::DeviceSize size,
-                  vk::raii::CommandPool& commandPool,
-                  vk::raii::Device& device,
-                  vk::Queue& graphicsQueue) {
-    vk::CommandBufferAllocateInfo allocInfo{};
-    allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
-    allocInfo.setCommandPool(*commandPool);
-    allocInfo.setCommandBufferCount(1);
-
-    auto commandBuffers = device.allocateCommandBuffers(allocInfo);
-    vk::CommandBuffer cmd = commandBuffers[0];
-
-    vk::CommandBufferBeginInfo beginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
-    cmd.begin(beginInfo);
-
-    vk::BufferCopy copyRegion{0, 0, size};
-    cmd.copyBuffer(src.getBuffer(), dst.getBuffer(), copyRegion);
-
-    cmd.end();
-
-    vk::SubmitInfo submitInfo{};
-    submitInfo.setCommandBuffers(cmd);
-
-    graphicsQueue.submit(submitInfo);
-    graphicsQueue.waitIdle();
+void Buffer::initDeviceLocal(vma::Allocator& _allocator,
+                             const void* data,
+                             vk::DeviceSize size,
+                             vk::BufferUsageFlags usage,
+                             UploadManager& uploads) {
+    init(&_allocator, size, usage | vk::BufferUsageFlagBits::eTransferDst, false, true, MemoryCategory::Geometry);
+    uploads.upload(*this, data, size);
 }
 
-void IndexBuffer::init(vma::Allocator& _allocator,
-                       const std::vector<uint16_t>& indices,
-                       vk::raii::CommandPool& commandPool,
-                       vk::raii::Device& device,
-                       vk::Queue& graphicsQueue) {
-    vk::DeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-    Buffer staging;
-    staging.init(&_allocator, bufferSize, vk::BufferUsageFlagBits::eTransferSrc, true);
-    auto allocInfo = staging.getAllocationInfo();
-    auto alloc = staging.getAllocation();
-
-    if (allocInfo.pMappedData) {
-        std::memcpy(allocInfo.pMappedData, indices.data(), bufferSize);
-    } else {
-        void* data = staging.mapMemory();
-        std::memcpy(data, indices.data(), bufferSize);
-        staging.unmapMemory();
+uint32_t GetIndexSize(vk::IndexType type) {
+    switch (type) {
+        case vk::IndexType::eUint8KHR:
+            return 1;
+        case vk::IndexType::eUint16:
+            return 2;
+        case vk::IndexType::eUint32:
+            return 4;
+        default:
+            throw std::runtime_error(std::format("Unsupported index type {}", vk::to_string(type)));
     }
+}
 
-    Buffer::init(&_allocator, bufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                 false, true);
-
-    Buffer::copy(staging, *this, bufferSize, commandPool, device, graphicsQueue);
-    indexCount = static_cast<uint32_t>(indices.size());
-
-    staging.destroy();
+vk::IndexType ChooseIndexType(uint32_t vertexCount, bool uint8Supported) {
+    if (uint8Supported && vertexCount <= 0x100) {
+        return vk::IndexType::eUint8KHR;
+    }
+    return vertexCount <= 0x10000 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
 }
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
@@ -10,17 +10,19 @@ namespace Solaris::Graphics::Vulkan {
 
 void Context::initCommands(size_t frameCount) {
     // Frames
-    frames.getAll().resize(frameCount);
+    frames.init(device, frameCount);
+    deletionQueue.init(frames);
 
     // Command Pool
-    vk::CommandPoolCreateInfo c{vk::CommandPoolCreateFlagBits::eResetCommandBuffer, 0};
+    vk::CommandPoolCreateInfo c{vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                                queueFamilies.graphicsFamily.value()};
     commandPool = {device, c};
 
     // Command Buffer
     vk::CommandBufferAllocateInfo ci{};
     ci.setCommandPool(commandPool);
     ci.setLevel(vk::CommandBufferLevel::ePrimary);
-    ci.setCommandBufferCount(swapchainImages.size());
+    ci.setCommandBufferCount(static_cast<uint32_t>(frameCount));
 
     auto buffers = device.allocateCommandBuffers(ci);
     size_t i = 0;
@@ -28,8 +30,8 @@ void Context::initCommands(size_t frameCount) {
         frame.commandBuffer = std::move(buffers[i++]);
     }
 
-    frames.init(device, frameCount);
-    spdlog::info("Command pool created. Allocated {} command buffers.", buffers.size());
+    spdlog::info("Command pool created. Allocated {} command buffers for {} frames in flight.", buffers.size(),
+                 frameCount);
 }
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
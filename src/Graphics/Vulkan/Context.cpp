@@ -17,9 +17,11 @@
 #include <vk_mem_alloc_handles.hpp>
 #include <vk_mem_alloc_structs.hpp>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 VKAPI_ATTR VkBool32 VKAPI_CALL debugUtilsMessengerCallback(VkDebugUtilsMessageSeverityFlagBitsEXT message_severity,
@@ -65,17 +67,25 @@ VKAPI_ATTR VkBool32 VKAPI_CALL debugUtilsMessengerCallback(VkDebugUtilsMessageSe
 namespace Solaris::Graphics::Vulkan {
 
 const std::vector<const char*> validationLayers = {"VK_LAYER_KHRONOS_validation"};
+
+[[nodiscard]] std::vector<const char*> getDeviceExtensions(const bool& headless) {
+    std::vector<const char*> extensions;
+    if (!headless) {
+        extensions.push_back(vk::KHRSwapchainExtensionName);
+    }
 #if defined(__APPLE__) || defined(__MACH__)
-const std::vector<const char*> deviceExtensions = {vk::KHRSwapchainExtensionName, "VK_KHR_portability_subset"};
-#else
-const std::vector<const char*> deviceExtensions = {vk::KHRSwapchainExtensionName};
+    extensions.push_back("VK_KHR_portability_subset");
 #endif
+    return extensions;
+}
 
-[[nodiscard]] std::vector<const char*> getRequiredExtensions(const bool& validationEnabled) {
-    uint32_t glfwExtensionsCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionsCount);
-
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionsCount);
+[[nodiscard]] std::vector<const char*> getRequiredExtensions(const bool& validationEnabled, const bool& headless) {
+    std::vector<const char*> extensions;
+    if (!headless) {
+        uint32_t glfwExtensionsCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionsCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionsCount);
+    }
     if (validationEnabled) {
         extensions.push_back(vk::EXTDebugUtilsExtensionName);
     }
@@ -85,8 +95,9 @@ const std::vector<const char*> deviceExtensions = {vk::KHRSwapchainExtensionName
     return extensions;
 }
 
-[[nodiscard]] bool checkDeviceExtensionSupport(const vk::raii::PhysicalDevice& device) {
+[[nodiscard]] bool checkDeviceExtensionSupport(const vk::raii::PhysicalDevice& device, const bool& headless) {
     auto availableExtensions = device.enumerateDeviceExtensionProperties();
+    auto deviceExtensions = getDeviceExtensions(headless);
     std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
 
     for (const auto& extension : availableExtensions) {
@@ -103,10 +114,12 @@ const std::vector<const char*> deviceExtensions = {vk::KHRSwapchainExtensionName
     auto deviceFeatures = device.getFeatures();
     auto indices = FindQueueFamilies(device, surface);
 
-    bool extensionsSupported = checkDeviceExtensionSupport(device);
-    bool swapChainAdequate = false;
+    // Without a surface there is nothing to present to, so only the graphics queue matters.
+    bool headless = *surface == VK_NULL_HANDLE;
+    bool extensionsSupported = checkDeviceExtensionSupport(device, headless);
+    bool swapChainAdequate = headless;
 
-    if (extensionsSupported) {
+    if (extensionsSupported && !headless) {
         auto swapChainSupport = QuerySwapChainSupport(surface, device);
         swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
     }
@@ -125,7 +138,7 @@ const std::vector<const char*> deviceExtensions = {vk::KHRSwapchainExtensionName
     return score;
 }
 
-void Context::init(GLFWwindow* window) {
+void Context::init(GLFWwindow* window, size_t framesInFlight) {
     // Instance + Devices
     initCore(window);
     // Swapchain + Render Pass
@@ -133,7 +146,42 @@ void Context::init(GLFWwindow* window) {
     // Views + Framebuffers
     initSwapchainResources();
     // Command Pool + Command Buffer + Frames
-    initCommands(swapchainViews.size());
+    initCommands(framesInFlight);
+    // Per-thread Command Pools
+    initRecorder();
+    // Upload Manager
+    initUploads();
+    // Per-frame ring buffer
+    initTransientBuffer(FrameRingBuffer::kDefaultFrameSize);
+    // Bindless Descriptors
+    initDescriptors();
+    // Shader Registry
+    initShaders(GetShaderDirectory());
+    // Pipeline Registry + Cache
+    initPipelines("pipeline_cache.bin");
+}
+
+void Context::initHeadless(vk::Extent2D extent, uint32_t imageCount, size_t framesInFlight) {
+    // Instance + Devices, no surface
+    initCore(nullptr);
+    // Offscreen images + Render Pass
+    initOffscreen(extent, imageCount);
+    // Views + Framebuffers
+    initSwapchainResources();
+    // Command Pool + Command Buffer + Frames
+    initCommands(std::min<size_t>(framesInFlight, imageCount));
+    // Per-thread Command Pools
+    initRecorder();
+    // Upload Manager
+    initUploads();
+    // Per-frame ring buffer
+    initTransientBuffer(FrameRingBuffer::kDefaultFrameSize);
+    // Bindless Descriptors
+    initDescriptors();
+    // Shader Registry
+    initShaders(GetShaderDirectory());
+    // Pipeline Registry + Cache
+    initPipelines("pipeline_cache.bin");
 }
 
 void Context::initCore(GLFWwindow* window) {
@@ -143,11 +191,12 @@ void Context::initCore(GLFWwindow* window) {
     ai.setApplicationVersion(VK_MAKE_VERSION(0, 0, 1));
     ai.setPEngineName("Solaris");
     ai.setEngineVersion(VK_MAKE_VERSION(0, 0, 1));
-    ai.setApiVersion(VK_API_VERSION_1_1);
+    ai.setApiVersion(VK_API_VERSION_1_2);
 
     spdlog::info("Initializing Solaris Vulkan Engine v{}.{}.{}", 0, 0, 1);
 
-    std::vector<const char*> extensions = getRequiredExtensions(validationEnabled);
+    headless = window == nullptr;
+    std::vector<const char*> extensions = getRequiredExtensions(validationEnabled, headless);
     vk::InstanceCreateInfo ici{};
     ici.setPApplicationInfo(&ai);
     ici.setEnabledExtensionCount(static_cast<uint32_t>(extensions.size()));
@@ -182,12 +231,16 @@ void Context::initCore(GLFWwindow* window) {
     }
 
     // Surface
-    VkSurfaceKHR _surface;
-    if (auto result = glfwCreateWindowSurface(*instance, window, nullptr, &_surface); result != VK_SUCCESS) {
-        throw std::runtime_error(std::format("Failed to create window surface: {}", string_VkResult(result)));
+    if (headless) {
+        spdlog::info("Running headless, skipping window surface creation.");
+    } else {
+        VkSurfaceKHR _surface;
+        if (auto result = glfwCreateWindowSurface(*instance, window, nullptr, &_surface); result != VK_SUCCESS) {
+            throw std::runtime_error(std::format("Failed to create window surface: {}", string_VkResult(result)));
+        }
+        surface = {instance, _surface};
+        spdlog::info("Window surface created successfully.");
     }
-    surface = {instance, _surface};
-    spdlog::info("Window surface created successfully.");
 
     // Physical Device
     std::vector<vk::raii::PhysicalDevice> devices = instance.enumeratePhysicalDevices();
@@ -218,6 +271,9 @@ void Context::initCore(GLFWwindow* window) {
     auto indices = FindQueueFamilies(physicalDevice, surface);
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily.value(), indices.presentFamily.value()};
+    if (indices.hasDedicatedTransfer()) {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -228,10 +284,101 @@ void Context::initCore(GLFWwindow* window) {
     spdlog::info("Creating logical device with {} queues.", uniqueQueueFamilies.size());
     spdlog::debug("Graphics queue family: {}", indices.graphicsFamily.value());
     spdlog::debug("Present queue family: {}", indices.presentFamily.value());
+    if (indices.hasDedicatedTransfer()) {
+        spdlog::debug("Transfer queue family: {}", indices.transferFamily.value());
+    }
+
+    auto supported = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features,
+                                                 vk::PhysicalDeviceVulkan12Features>();
+    const auto& supportedCore = supported.get<vk::PhysicalDeviceFeatures2>().features;
+    const auto& supported11 = supported.get<vk::PhysicalDeviceVulkan11Features>();
+    const auto& supported12 = supported.get<vk::PhysicalDeviceVulkan12Features>();
 
-    vk::PhysicalDeviceFeatures df{};
+    if (!supported12.timelineSemaphore) {
+        throw std::runtime_error("Selected device does not support timeline semaphores.");
+    }
+    features.pipelineStatisticsQuery = supportedCore.pipelineStatisticsQuery == vk::True;
+    features.multiDrawIndirect = supportedCore.multiDrawIndirect == vk::True;
+    features.drawIndirectFirstInstance = supportedCore.drawIndirectFirstInstance == vk::True;
+    features.shaderDrawParameters = supported11.shaderDrawParameters == vk::True;
+    features.drawIndirectCount = supported12.drawIndirectCount == vk::True;
+    features.descriptorIndexing =
+        supported12.descriptorIndexing && supported12.runtimeDescriptorArray &&
+        supported12.descriptorBindingPartiallyBound && supported12.descriptorBindingUpdateUnusedWhilePending &&
+        supported12.descriptorBindingStorageBufferUpdateAfterBind &&
+        supported12.descriptorBindingSampledImageUpdateAfterBind &&
+        supported12.shaderStorageBufferArrayNonUniformIndexing && supported12.shaderSampledImageArrayNonUniformIndexing;
+
+    // Present wait needs both extensions and both features.
+    auto deviceExtensions = getDeviceExtensions(headless);
+    auto availableExtensions = physicalDevice.enumerateDeviceExtensionProperties();
+    auto hasExtension = [&](std::string_view name) {
+        return std::ranges::any_of(availableExtensions,
+                                   [&](const auto& extension) { return name == extension.extensionName.data(); });
+    };
+    if (!headless && hasExtension(vk::KHRPresentIdExtensionName) && hasExtension(vk::KHRPresentWaitExtensionName)) {
+        auto present = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDevicePresentIdFeaturesKHR,
+                                                   vk::PhysicalDevicePresentWaitFeaturesKHR>();
+        features.presentWait = present.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId &&
+                               present.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+    }
+    if (features.presentWait) {
+        deviceExtensions.push_back(vk::KHRPresentIdExtensionName);
+        deviceExtensions.push_back(vk::KHRPresentWaitExtensionName);
+    }
+    // Real budgets from the driver, VMA falls back to a fraction of each heap's size without it.
+    features.memoryBudget = hasExtension(vk::EXTMemoryBudgetExtensionName);
+    if (features.memoryBudget) {
+        deviceExtensions.push_back(vk::EXTMemoryBudgetExtensionName);
+    }
+    // 8-bit indices for meshes of up to 256 vertices, see ChooseIndexType.
+    if (hasExtension(vk::KHRIndexTypeUint8ExtensionName)) {
+        auto uint8 =
+            physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceIndexTypeUint8FeaturesKHR>();
+        features.indexTypeUint8 = uint8.get<vk::PhysicalDeviceIndexTypeUint8FeaturesKHR>().indexTypeUint8 == vk::True;
+    }
+    if (features.indexTypeUint8) {
+        deviceExtensions.push_back(vk::KHRIndexTypeUint8ExtensionName);
+    }
+
+    vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features,
+                       vk::PhysicalDeviceVulkan12Features, vk::PhysicalDevicePresentIdFeaturesKHR,
+                       vk::PhysicalDevicePresentWaitFeaturesKHR, vk::PhysicalDeviceIndexTypeUint8FeaturesKHR>
+        enabled{};
+    auto& df = enabled.get<vk::PhysicalDeviceFeatures2>().features;
+    df.setPipelineStatisticsQuery(supportedCore.pipelineStatisticsQuery);
+    df.setMultiDrawIndirect(supportedCore.multiDrawIndirect);
+    // GpuCulling passes each object's transform index as the draw's firstInstance.
+    df.setDrawIndirectFirstInstance(supportedCore.drawIndirectFirstInstance);
+    enabled.get<vk::PhysicalDeviceVulkan11Features>().setShaderDrawParameters(supported11.shaderDrawParameters);
+    auto& df12 = enabled.get<vk::PhysicalDeviceVulkan12Features>();
+    df12.setTimelineSemaphore(vk::True);
+    df12.setDrawIndirectCount(supported12.drawIndirectCount);
+    if (features.descriptorIndexing) {
+        df12.setDescriptorIndexing(vk::True);
+        df12.setRuntimeDescriptorArray(vk::True);
+        df12.setDescriptorBindingPartiallyBound(vk::True);
+        df12.setDescriptorBindingUpdateUnusedWhilePending(vk::True);
+        df12.setDescriptorBindingStorageBufferUpdateAfterBind(vk::True);
+        df12.setDescriptorBindingSampledImageUpdateAfterBind(vk::True);
+        df12.setShaderStorageBufferArrayNonUniformIndexing(vk::True);
+        df12.setShaderSampledImageArrayNonUniformIndexing(vk::True);
+    }
+    if (features.presentWait) {
+        enabled.get<vk::PhysicalDevicePresentIdFeaturesKHR>().setPresentId(vk::True);
+        enabled.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().setPresentWait(vk::True);
+    } else {
+        enabled.unlink<vk::PhysicalDevicePresentIdFeaturesKHR>();
+        enabled.unlink<vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    }
+    if (features.indexTypeUint8) {
+        enabled.get<vk::PhysicalDeviceIndexTypeUint8FeaturesKHR>().setIndexTypeUint8(vk::True);
+    } else {
+        enabled.unlink<vk::PhysicalDeviceIndexTypeUint8FeaturesKHR>();
+    }
     vk::DeviceCreateInfo di{{}, static_cast<uint32_t>(queueCreateInfos.size()), queueCreateInfos.data(), {},
-                            {}, static_cast<uint32_t>(deviceExtensions.size()), deviceExtensions.data(), &df};
+                            {}, static_cast<uint32_t>(deviceExtensions.size()), deviceExtensions.data(), nullptr};
+    di.setPNext(&enabled.get<vk::PhysicalDeviceFeatures2>());
     if (validationEnabled) {
         di.setEnabledLayerCount(static_cast<uint32_t>(validationLayers.size()));
         di.setPpEnabledLayerNames(validationLayers.data());
@@ -240,16 +387,89 @@ void Context::initCore(GLFWwindow* window) {
     }
 
     device = {physicalDevice, di};
+    queueFamilies = indices;
     graphicsQueue = device.getQueue(indices.graphicsFamily.value(), 0);
     presentQueue = device.getQueue(indices.presentFamily.value(), 0);
+    transferQueue = indices.hasDedicatedTransfer() ? device.getQueue(indices.transferFamily.value(), 0) : graphicsQueue;
 
     // Vulkan Memory Allocator
     vma::AllocatorCreateInfo aci{};
-    aci.setVulkanApiVersion(physicalDevice.getProperties().apiVersion);
+    aci.setVulkanApiVersion(std::min(physicalDevice.getProperties().apiVersion, VK_API_VERSION_1_2));
     aci.setPhysicalDevice(*physicalDevice);
     aci.setDevice(*device);
     aci.setInstance(*instance);
+    if (features.memoryBudget) {
+        aci.setFlags(vma::AllocatorCreateFlagBits::eExtMemoryBudget);
+    }
     allocator = vma::createAllocator(aci);
+    allocator.initRelocatablePool();
+    memory.init(*allocator, physicalDevice, features.memoryBudget);
+}
+
+void Context::initRecorder() {
+    if (jobs == nullptr) {
+        throw std::runtime_error("Context needs a job system before the recorder can be initialized");
+    }
+    recorder.init(device, queueFamilies.graphicsFamily.value(), frames.getAll().size(), *jobs);
+}
+
+void Context::initUploads() {
+    uploads.init(device, &*allocator, queueFamilies, graphicsQueue, transferQueue);
+}
+
+void Context::initDescriptors() {
+    descriptors.init(device, physicalDevice, features.descriptorIndexing, deletionQueue);
+}
+
+void Context::initShaders(const std::filesystem::path& directory) {
+    shaders.init(device, directory);
+}
+
+void Context::initPipelines(const std::filesystem::path& cachePath) {
+    pipelines.init(device, physicalDevice, cachePath, deletionQueue);
+}
+
+void Context::initTransientBuffer(vk::DeviceSize frameSize) {
+    transientBuffer.init(&*allocator, physicalDevice, frames.getAll().size(), frameSize);
+}
+
+void Context::beginFrame() {
+    uploads.collect();
+    streamer.update();
+    transientBuffer.beginFrame(frames.getCurrentIndex());
+    recorder.beginFrame(frames.getCurrentIndex());
+    deletionQueue.collect(frames.getCompletedValue());
+    memory.update();
+
+    if (shaders.isWatching()) {
+        pipelines.reload(shaders.pollChanges(), shaders);
+    }
+    pipelines.update();
+}
+
+void Context::initStreamer(const AssetStreamer::Config& config) {
+    streamer.init(&*allocator, physicalDevice.getMemoryProperties(), uploads, config);
+    // Sheds resident streamed data while a device-local heap is over the threshold, before the driver pages.
+    memory.setBudgetCallback(config.evictionThreshold, [this, config](uint32_t heap, const MemoryReport& report) {
+        const auto& state = report.heaps[heap];
+        auto limit = static_cast<vk::DeviceSize>(static_cast<double>(state.budget) * config.evictionThreshold);
+        if (state.deviceLocal && state.usage > limit) {
+            streamer.evict(heap, state.usage - limit);
+        }
+    });
+}
+
+void Context::initDefragmenter(const Defragmenter::Config& config) {
+    defragmenter.init(allocator, device, frames, uploads, config);
+}
+
+void Context::initProfiler(bool pipelineStatistics) {
+    if (pipelineStatistics && !features.pipelineStatisticsQuery) {
+        spdlog::warn("Pipeline statistics queries are not supported on this device.");
+        pipelineStatistics = false;
+    }
+    profiler.init(device, physicalDevice, queueFamilies.graphicsFamily.value(), frames.getAll().size(),
+                  pipelineStatistics);
 }
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "Graphics/Vulkan/Culling.hpp"
+#include "Graphics/Vulkan/Shader.hpp"
+#include "Graphics/Vulkan/Upload.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <format>
+#include <stdexcept>
+
+namespace Solaris::Graphics::Vulkan {
+
+constexpr uint32_t cullGroupSize = 64;
+constexpr vk::DeviceSize drawStride = sizeof(vk::DrawIndexedIndirectCommand);
+
+struct CullConstants {
+    FrustumPlanes planes;
+    uint32_t objectCount;
+    uint32_t compact;
+    uint32_t firstInstance;
+};
+
+FrustumPlanes ExtractFrustumPlanes(const glm::mat4& m) {
+    auto row = [&](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+
+    FrustumPlanes planes = {
+        row(3) + row(0),  // left
+        row(3) - row(0),  // right
+        row(3) + row(1),  // bottom
+        row(3) - row(1),  // top
+        row(2),           // near, depth range is [0, 1]
+        row(3) - row(2),  // far
+    };
+    for (auto& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return planes;
+}
+
+void GpuCulling::init(const vk::raii::Device& _device,
+                      vma::Allocator* _allocator,
+                      ShaderRegistry& shaders,
+                      const vk::raii::PipelineCache& cache,
+                      size_t framesInFlight,
+                      uint32_t _maxObjects,
+                      uint32_t _maxBatches,
+                      bool drawIndirectCount,
+                      bool multiDrawIndirect,
+                      bool drawIndirectFirstInstance) {
+    device = &_device;
+    allocator = _allocator;
+    maxObjects = _maxObjects;
+    maxBatches = _maxBatches;
+    compact = drawIndirectCount;
+    multiDraw = multiDrawIndirect;
+    firstInstance = drawIndirectFirstInstance;
+
+    if (!compact) {
+        spdlog::warn("drawIndirectCount is not supported, culled objects are drawn with zero instances.");
+    }
+    if (!firstInstance) {
+        spdlog::warn("drawIndirectFirstInstance is not supported, transform indices go through the draw buffer.");
+    }
+
+    std::array<vk::DescriptorSetLayoutBinding, 5> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i] = {i, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute};
+    }
+    vk::DescriptorSetLayoutCreateInfo sli{};
+    sli.setBindings(bindings);
+    setLayout = {*device, sli};
+
+    vk::DescriptorPoolSize poolSize{vk::DescriptorType::eStorageBuffer,
+                                    static_cast<uint32_t>(bindings.size() * framesInFlight)};
+    vk::DescriptorPoolCreateInfo dpi{};
+    dpi.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+    dpi.setMaxSets(static_cast<uint32_t>(framesInFlight));
+    dpi.setPoolSizes(poolSize);
+    pool = {*device, dpi};
+
+    vk::PushConstantRange pushRange{vk::ShaderStageFlagBits::eCompute, 0, sizeof(CullConstants)};
+    vk::PipelineLayoutCreateInfo pli{};
+    pli.setSetLayouts(*setLayout);
+    pli.setPushConstantRanges(pushRange);
+    pipelineLayout = {*device, pli};
+
+    auto stage = shaders.load("cull.comp.spv", vk::ShaderStageFlagBits::eCompute);
+    vk::ComputePipelineCreateInfo cpi{};
+    cpi.stage.setStage(stage.stage);
+    cpi.stage.setModule(stage.module);
+    cpi.stage.setPName(stage.entryPoint.c_str());
+    cpi.setLayout(*pipelineLayout);
+    pipeline = {*device, cache, cpi};
+
+    auto storage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst;
+    objectBuffer.init(allocator, sizeof(GpuObject) * maxObjects, storage, false, true);
+    batchBuffer.init(allocator, sizeof(DrawBatch) * maxBatches, storage, false, true);
+
+    frames.resize(framesInFlight);
+    for (auto& frame : frames) {
+        auto indirect = storage | vk::BufferUsageFlagBits::eIndirectBuffer;
+        frame.draws.init(allocator, drawStride * maxObjects, indirect, false, true, MemoryCategory::PerFrame);
+        frame.counts.init(allocator, sizeof(uint32_t) * maxBatches, indirect, false, true, MemoryCategory::PerFrame);
+        frame.transforms.init(allocator, sizeof(uint32_t) * maxObjects, storage, false, true,
+                              MemoryCategory::PerFrame);
+
+        vk::DescriptorSetAllocateInfo dai{};
+        dai.setDescriptorPool(*pool);
+        dai.setSetLayouts(*setLayout);
+        frame.set = std::move(vk::raii::DescriptorSets(*device, dai).front());
+
+        std::array<vk::DescriptorBufferInfo, 5> infos{{
+            {objectBuffer.getBuffer(), 0, VK_WHOLE_SIZE},
+            {batchBuffer.getBuffer(), 0, VK_WHOLE_SIZE},
+            {frame.draws.getBuffer(), 0, VK_WHOLE_SIZE},
+            {frame.counts.getBuffer(), 0, VK_WHOLE_SIZE},
+            {frame.transforms.getBuffer(), 0, VK_WHOLE_SIZE},
+        }};
+        std::array<vk::WriteDescriptorSet, 5> writes{};
+        for (uint32_t i = 0; i < writes.size(); i++) {
+            writes[i].setDstSet(*frame.set);
+            writes[i].setDstBinding(i);
+            writes[i].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+            writes[i].setBufferInfo(infos[i]);
+        }
+        device->updateDescriptorSets(writes, {});
+    }
+}
+
+void GpuCulling::setObjects(std::span<const GpuObject> objects,
+                            std::span<const DrawBatch> _batches,
+                            UploadManager& uploads) {
+    if (objects.size() > maxObjects || _batches.size() > maxBatches) {
+        throw std::runtime_error(std::format("GpuCulling holds at most {} objects in {} batches, got {} in {}",
+                                             maxObjects, maxBatches, objects.size(), _batches.size()));
+    }
+
+    objectCount = static_cast<uint32_t>(objects.size());
+    batches.assign(_batches.begin(), _batches.end());
+    uploads.upload(objectBuffer, objects.data(), objects.size_bytes());
+    uploads.upload(batchBuffer, batches.data(), batches.size() * sizeof(DrawBatch));
+}
+
+void GpuCulling::updateObjects(uint32_t first, std::span<const GpuObject> objects, FrameRingBuffer& ring) {
+    if (first + objects.size() > objectCount) {
+        throw std::runtime_error(std::format("Object update [{}, {}) is out of range ({} objects)", first,
+                                             first + objects.size(), objectCount));
+    }
+
+    auto staged = ring.push(objects, alignof(GpuObject));
+    pendingSource = staged.buffer;
+    pendingCopies.push_back({staged.offset, first * sizeof(GpuObject), staged.size});
+}
+
+void GpuCulling::cull(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, const FrustumPlanes& planes) {
+    auto& frame = frames[frameIndex];
+
+    // Earlier frames may still be reading the object buffer, and this frame's count buffer was last consumed
+    // as indirect arguments.
+    vk::MemoryBarrier before{vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eIndirectCommandRead,
+                             vk::AccessFlagBits::eTransferWrite};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect,
+                        vk::PipelineStageFlagBits::eTransfer, {}, before, {}, {});
+
+    if (!pendingCopies.empty()) {
+        cmd.copyBuffer(pendingSource, objectBuffer.getBuffer(), pendingCopies);
+        pendingCopies.clear();
+    }
+    if (compact) {
+        cmd.fillBuffer(frame.counts.getBuffer(), 0, VK_WHOLE_SIZE, 0);
+    }
+
+    vk::MemoryBarrier transferToCompute{vk::AccessFlagBits::eTransferWrite,
+                                        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader, {},
+                        transferToCompute, {}, {});
+
+    CullConstants constants{planes, objectCount, compact ? 1u : 0u, firstInstance ? 1u : 0u};
+    cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, {*frame.set}, {});
+    cmd.pushConstants<CullConstants>(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, constants);
+    cmd.dispatch((objectCount + cullGroupSize - 1) / cullGroupSize, 1, 1);
+
+    // Vertex shaders may read the draw transforms.
+    vk::MemoryBarrier computeToIndirect{vk::AccessFlagBits::eShaderWrite,
+                                        vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                        vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexShader, {},
+                        computeToIndirect, {}, {});
+}
+
+void GpuCulling::draw(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, uint32_t batch) const {
+    const auto& frame = frames[frameIndex];
+    const auto& range = batches[batch];
+    vk::DeviceSize offset = range.firstObject * drawStride;
+
+    if (compact) {
+        cmd.drawIndexedIndirectCount(frame.draws.getBuffer(), offset, frame.counts.getBuffer(),
+                                     batch * sizeof(uint32_t), range.objectCount, drawStride);
+    } else if (multiDraw) {
+        cmd.drawIndexedIndirect(frame.draws.getBuffer(), offset, range.objectCount, drawStride);
+    } else {
+        for (uint32_t i = 0; i < range.objectCount; i++) {
+            cmd.drawIndexedIndirect(frame.draws.getBuffer(), offset + i * drawStride, 1, drawStride);
+        }
+    }
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,226 @@
+#include "Graphics/Vulkan/Defragmenter.hpp"
+#include "Graphics/Vulkan/Allocator.hpp"
+#include "Graphics/Vulkan/Buffer.hpp"
+#include "Graphics/Vulkan/Frame.hpp"
+#include "Graphics/Vulkan/Upload.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace Solaris::Graphics::Vulkan {
+
+namespace {
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+Buffer* getOwner(const vma::Allocator& allocator, vma::Allocation allocation) {
+    return static_cast<Buffer*>(allocator.getAllocationInfo(allocation).pUserData);
+}
+
+}  // namespace
+
+Defragmenter::~Defragmenter() {
+    // Normally shut down already. Otherwise, e.g. when unwinding from an exception, the owners of the moved buffers
+    // may be gone, so the run is abandoned using the allocations alone. Buffer::destroy clears the user data of a
+    // buffer being moved, those allocations are freed with the pass. Only destroyed with the device idle.
+    if (passPending) {
+        for (uint32_t i = 0; i < pass.moveCount; i++) {
+            auto& move = pass.pMoves[i];
+            if (move.operation == vma::DefragmentationMoveOperation::eCopy &&
+                getOwner(*allocator, move.srcAllocation) == nullptr) {
+                move.operation = vma::DefragmentationMoveOperation::eDestroy;
+            }
+        }
+        for (auto old : replaced) {
+            allocator->destroyBuffer(old, nullptr);
+        }
+        (void)allocator->endDefragmentationPass(context, &pass);
+    }
+    if (context) {
+        allocator->endDefragmentation(context, nullptr);
+    }
+}
+
+void Defragmenter::init(Allocator& _allocator,
+                        const vk::raii::Device& _device,
+                        const Frames& _frames,
+                        UploadManager& _uploads,
+                        const Config& _config) {
+    allocator = &*_allocator;
+    pool = _allocator.getRelocatablePool();
+    memoryTypeIndex = _allocator.getRelocatableMemoryType();
+    device = &_device;
+    frames = &_frames;
+    uploads = &_uploads;
+    config = _config;
+}
+
+void Defragmenter::shutdown() {
+    if (passPending) {
+        endPass();
+    }
+    if (context) {
+        finish();
+    }
+}
+
+void Defragmenter::update(const vk::raii::CommandBuffer& cmd) {
+    if (!allocator) {
+        return;
+    }
+
+    if (passPending) {
+        if (frames->getCompletedValue() < passValue) {
+            return;
+        }
+        endPass();
+    }
+
+    if (!context) {
+        if (frames->getSubmittedValue() < nextCheck) {
+            return;
+        }
+        if (!shouldStart()) {
+            nextCheck = frames->getSubmittedValue() + config.cooldownFrames;
+            return;
+        }
+        vma::DefragmentationInfo info{};
+        info.setPool(pool);
+        info.setMaxBytesPerPass(config.maxBytesPerPass);
+        info.setMaxAllocationsPerPass(config.maxMovesPerPass);
+        context = allocator->beginDefragmentation(info);
+    }
+    beginPass(cmd);
+}
+
+bool Defragmenter::shouldStart() const {
+    // Unused space in the largest free range, e.g. the tail of a barely used block, is not fragmentation: moving
+    // allocations would not make it any more usable. VMA reports free ranges per memory type, which includes the
+    // default pool of the type, so the pool's own unused space caps the estimate.
+    auto type = allocator->calculateStatistics().memoryType[memoryTypeIndex];
+    vk::DeviceSize unused = type.statistics.blockBytes - type.statistics.allocationBytes;
+    if (unused == 0 || type.unusedRangeCount < 2) {
+        return false;
+    }
+    auto stats = allocator->getPoolStatistics(pool);
+    vk::DeviceSize scattered = std::min(unused - type.unusedRangeSizeMax, stats.blockBytes - stats.allocationBytes);
+    float fragmentation = static_cast<float>(scattered) / static_cast<float>(unused);
+    return fragmentation >= config.fragmentationThreshold && scattered >= config.minReclaimable;
+}
+
+void Defragmenter::beginPass(const vk::raii::CommandBuffer& cmd) {
+    if (allocator->beginDefragmentationPass(context, &pass) == vk::Result::eSuccess) {
+        // Nothing left to move.
+        finish();
+        return;
+    }
+
+    for (uint32_t i = 0; i < pass.moveCount; i++) {
+        auto& move = pass.pMoves[i];
+        Buffer* buffer = getOwner(*allocator, move.srcAllocation);
+        if (buffer == nullptr || !buffer->relocatable) {
+            move.operation = vma::DefragmentationMoveOperation::eIgnore;
+            continue;
+        }
+
+        if (replaced.empty()) {
+            // Pending uploads were recorded against the current handles. Submitting them now makes the frame wait
+            // for them, so the copies below see their data.
+            uploads->flush();
+
+            vk::MemoryBarrier before{vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eTransferRead};
+            cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {},
+                                before, {}, {});
+        }
+
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.setSize(buffer->size);
+        bufferInfo.setUsage(buffer->usage);
+        bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
+        vk::Buffer moved = device->createBuffer(bufferInfo).release();
+        allocator->bindBufferMemory(move.dstTmpAllocation, moved);
+
+        cmd.copyBuffer(buffer->_buffer, moved, vk::BufferCopy{0, 0, buffer->size});
+        replaced.push_back(buffer->_buffer);
+        buffer->_buffer = moved;
+        buffer->relocating = true;
+    }
+
+    if (replaced.empty()) {
+        // Nothing this pass could move, no GPU work to wait for.
+        endPass();
+        return;
+    }
+
+    vk::MemoryBarrier after{vk::AccessFlagBits::eTransferWrite,
+                            vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+                                vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eTransferRead |
+                                vk::AccessFlagBits::eTransferWrite};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader |
+                            vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer,
+                        {}, after, {}, {});
+
+    // The frame being recorded carries the copies.
+    passPending = true;
+    passValue = frames->getSubmittedValue() + 1;
+}
+
+void Defragmenter::endPass() {
+    std::vector<Buffer*> moved;
+    for (uint32_t i = 0; i < pass.moveCount; i++) {
+        auto& move = pass.pMoves[i];
+        if (move.operation != vma::DefragmentationMoveOperation::eCopy) {
+            continue;
+        }
+        Buffer* buffer = getOwner(*allocator, move.srcAllocation);
+        if (buffer == nullptr) {
+            // Destroyed while its copy was in flight.
+            move.operation = vma::DefragmentationMoveOperation::eDestroy;
+        } else {
+            buffer->relocating = false;
+            moved.push_back(buffer);
+        }
+    }
+    // Every frame that could read the old handles has completed.
+    for (auto old : replaced) {
+        allocator->destroyBuffer(old, nullptr);
+    }
+    replaced.clear();
+    passPending = false;
+
+    bool done = allocator->endDefragmentationPass(context, &pass) == vk::Result::eSuccess;
+    // The allocations now point at their new memory.
+    for (auto* buffer : moved) {
+        buffer->allocInfo = allocator->getAllocationInfo(buffer->allocation);
+    }
+    if (done) {
+        finish();
+    }
+}
+
+void Defragmenter::finish() {
+    vma::DefragmentationStats stats{};
+    allocator->endDefragmentation(context, &stats);
+    context = nullptr;
+    nextCheck = frames->getSubmittedValue() + config.cooldownFrames;
+
+    totals.bytesMoved += stats.bytesMoved;
+    totals.bytesFreed += stats.bytesFreed;
+    totals.allocationsMoved += stats.allocationsMoved;
+    totals.deviceMemoryBlocksFreed += stats.deviceMemoryBlocksFreed;
+    runs++;
+
+    spdlog::info("Defragmentation moved {} allocations ({:.1f} MiB), {:.1f} MiB reclaimed in {} blocks.",
+                 stats.allocationsMoved, static_cast<double>(stats.bytesMoved) / kMiB,
+                 static_cast<double>(stats.bytesFreed) / kMiB, stats.deviceMemoryBlocksFreed);
+}
+
+void Defragmenter::logSummary() const {
+    spdlog::info("Defragmentation: {} runs, {} allocations moved ({:.1f} MiB), {:.1f} MiB reclaimed in {} blocks.",
+                 runs, totals.allocationsMoved, static_cast<double>(totals.bytesMoved) / kMiB,
+                 static_cast<double>(totals.bytesFreed) / kMiB, totals.deviceMemoryBlocksFreed);
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,53 @@
+#include "Graphics/Vulkan/DeletionQueue.hpp"
+#include "Graphics/Vulkan/Frame.hpp"
+
+namespace Solaris::Graphics::Vulkan {
+
+DeletionQueue::~DeletionQueue() {
+    // Callbacks may point at objects that are already gone, only the captured resources are released.
+    std::lock_guard lock(mutex);
+    entries.clear();
+}
+
+void DeletionQueue::init(const Frames& _frames) {
+    frames = &_frames;
+}
+
+void DeletionQueue::defer(std::move_only_function<void()> callback) {
+    std::lock_guard lock(mutex);
+    // The frame being built signals one past the last submitted value.
+    entries.push_back({frames->getSubmittedValue() + 1, std::move(callback)});
+}
+
+void DeletionQueue::collect(uint64_t completedValue) {
+    // Run outside the lock, a callback may hand over more resources.
+    std::vector<Entry> ready;
+    {
+        std::lock_guard lock(mutex);
+        while (!entries.empty() && entries.front().value <= completedValue) {
+            ready.push_back(std::move(entries.front()));
+            entries.pop_front();
+        }
+    }
+    for (auto& entry : ready) {
+        entry.callback();
+    }
+}
+
+void DeletionQueue::flush() {
+    std::deque<Entry> all;
+    {
+        std::lock_guard lock(mutex);
+        all.swap(entries);
+    }
+    for (auto& entry : all) {
+        entry.callback();
+    }
+}
+
+size_t DeletionQueue::size() const {
+    std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,180 @@
+#include "Graphics/Vulkan/Descriptors.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
+
+namespace Solaris::Graphics::Vulkan {
+
+void BindlessDescriptors::init(const vk::raii::Device& _device,
+                               const vk::raii::PhysicalDevice& physicalDevice,
+                               bool supported,
+                               DeletionQueue& _deletionQueue,
+                               Capacity capacity) {
+    device = &_device;
+    deletionQueue = &_deletionQueue;
+    enabled = supported;
+
+    vk::PushConstantRange pushRange{vk::ShaderStageFlagBits::eAll, 0, kPushConstantSize};
+
+    if (!enabled) {
+        spdlog::warn("Descriptor indexing is not supported, bindless resources disabled.");
+        vk::PipelineLayoutCreateInfo pli{};
+        pli.setPushConstantRanges(pushRange);
+        pipelineLayout = {*device, pli};
+        return;
+    }
+
+    // Stay within what the device allows for update-after-bind sets.
+    auto properties =
+        physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+    const auto& limits = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+    buffers.capacity = std::min({capacity.storageBuffers, limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                 limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+    images.capacity = std::min({capacity.sampledImages, limits.maxDescriptorSetUpdateAfterBindSampledImages,
+                                limits.maxPerStageDescriptorUpdateAfterBindSampledImages});
+    samplers.capacity = std::min({capacity.samplers, limits.maxDescriptorSetUpdateAfterBindSamplers,
+                                  limits.maxPerStageDescriptorUpdateAfterBindSamplers});
+
+    std::array<vk::DescriptorSetLayoutBinding, 3> bindings{{
+        {kStorageBufferBinding, vk::DescriptorType::eStorageBuffer, buffers.capacity, vk::ShaderStageFlagBits::eAll},
+        {kSampledImageBinding, vk::DescriptorType::eSampledImage, images.capacity, vk::ShaderStageFlagBits::eAll},
+        {kSamplerBinding, vk::DescriptorType::eSampler, samplers.capacity, vk::ShaderStageFlagBits::eAll},
+    }};
+
+    // Unregistered slots are never written, and slots may be written while the set is in use by the GPU.
+    vk::DescriptorBindingFlags bindingFlag = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                             vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                             vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+    std::array<vk::DescriptorBindingFlags, 3> bindingFlags{bindingFlag, bindingFlag, bindingFlag};
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo bfi{};
+    bfi.setBindingFlags(bindingFlags);
+
+    vk::DescriptorSetLayoutCreateInfo sli{};
+    sli.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
+    sli.setBindings(bindings);
+    sli.setPNext(&bfi);
+    setLayout = {*device, sli};
+
+    std::array<vk::DescriptorPoolSize, 3> poolSizes{{
+        {vk::DescriptorType::eStorageBuffer, buffers.capacity},
+        {vk::DescriptorType::eSampledImage, images.capacity},
+        {vk::DescriptorType::eSampler, samplers.capacity},
+    }};
+
+    vk::DescriptorPoolCreateInfo dpi{};
+    dpi.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind |
+                 vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+    dpi.setMaxSets(1);
+    dpi.setPoolSizes(poolSizes);
+    pool = {*device, dpi};
+
+    vk::DescriptorSetAllocateInfo dai{};
+    dai.setDescriptorPool(*pool);
+    dai.setSetLayouts(*setLayout);
+    set = std::move(vk::raii::DescriptorSets(*device, dai).front());
+
+    vk::PipelineLayoutCreateInfo pli{};
+    pli.setSetLayouts(*setLayout);
+    pli.setPushConstantRanges(pushRange);
+    pipelineLayout = {*device, pli};
+
+    spdlog::info("Bindless descriptors: {} storage buffers, {} sampled images, {} samplers.", buffers.capacity,
+                 images.capacity, samplers.capacity);
+}
+
+uint32_t BindlessDescriptors::allocate(Slots& slots, const char* kind) {
+    if (!enabled) {
+        throw std::runtime_error(std::format("Cannot register {}: bindless resources are disabled", kind));
+    }
+    if (!slots.free.empty()) {
+        uint32_t index = slots.free.back();
+        slots.free.pop_back();
+        return index;
+    }
+    if (slots.next == slots.capacity) {
+        throw std::runtime_error(std::format("Bindless {} table is full ({} slots)", kind, slots.capacity));
+    }
+    return slots.next++;
+}
+
+void BindlessDescriptors::release(Slots& slots, uint32_t index) {
+    if (index == kInvalidBindlessIndex) {
+        return;
+    }
+    // Frames in flight may still index the slot.
+    deletionQueue->defer([this, &slots, index] {
+        std::lock_guard lock(mutex);
+        slots.free.push_back(index);
+    });
+}
+
+BindlessIndex BindlessDescriptors::registerBuffer(vk::Buffer buffer, vk::DeviceSize offset, vk::DeviceSize range) {
+    std::lock_guard lock(mutex);
+    uint32_t index = allocate(buffers, "storage buffer");
+
+    vk::DescriptorBufferInfo info{buffer, offset, range};
+    vk::WriteDescriptorSet write{};
+    write.setDstSet(*set);
+    write.setDstBinding(kStorageBufferBinding);
+    write.setDstArrayElement(index);
+    write.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+    write.setBufferInfo(info);
+    device->updateDescriptorSets(write, {});
+    return index;
+}
+
+BindlessIndex BindlessDescriptors::registerImage(vk::ImageView view, vk::ImageLayout layout) {
+    std::lock_guard lock(mutex);
+    uint32_t index = allocate(images, "sampled image");
+
+    vk::DescriptorImageInfo info{VK_NULL_HANDLE, view, layout};
+    vk::WriteDescriptorSet write{};
+    write.setDstSet(*set);
+    write.setDstBinding(kSampledImageBinding);
+    write.setDstArrayElement(index);
+    write.setDescriptorType(vk::DescriptorType::eSampledImage);
+    write.setImageInfo(info);
+    device->updateDescriptorSets(write, {});
+    return index;
+}
+
+BindlessIndex BindlessDescriptors::registerSampler(vk::Sampler sampler) {
+    std::lock_guard lock(mutex);
+    uint32_t index = allocate(samplers, "sampler");
+
+    vk::DescriptorImageInfo info{sampler, VK_NULL_HANDLE, vk::ImageLayout::eUndefined};
+    vk::WriteDescriptorSet write{};
+    write.setDstSet(*set);
+    write.setDstBinding(kSamplerBinding);
+    write.setDstArrayElement(index);
+    write.setDescriptorType(vk::DescriptorType::eSampler);
+    write.setImageInfo(info);
+    device->updateDescriptorSets(write, {});
+    return index;
+}
+
+void BindlessDescriptors::releaseBuffer(BindlessIndex index) {
+    release(buffers, index);
+}
+
+void BindlessDescriptors::releaseImage(BindlessIndex index) {
+    release(images, index);
+}
+
+void BindlessDescriptors::releaseSampler(BindlessIndex index) {
+    release(samplers, index);
+}
+
+void BindlessDescriptors::bind(const vk::raii::CommandBuffer& cmd, vk::PipelineBindPoint bindPoint) const {
+    if (!enabled) {
+        return;
+    }
+    cmd.bindDescriptorSets(bindPoint, *pipelineLayout, 0, {*set}, {});
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -1,15 +1,15 @@
 #include "Graphics/Vulkan/Frame.hpp"
 #include <vulkan/vulkan_raii.hpp>
+#include <vulkan/vulkan_to_string.hpp>
+
+#include <format>
+#include <stdexcept>
 
 namespace Solaris::Graphics::Vulkan {
 
 void Frame::init(vk::raii::Device& device) {
-    vk::FenceCreateInfo f{vk::FenceCreateFlagBits::eSignaled};
     vk::SemaphoreCreateInfo s{};
-
-    inFlightFence = device.createFence(f);
     imageAvailableSemaphore = device.createSemaphore(s);
-    renderFinishedSemaphore = device.createSemaphore(s);
 }
 
 void Frames::init(vk::raii::Device& device, size_t frameCount) {
@@ -17,6 +17,28 @@ void Frames::init(vk::raii::Device& device, size_t frameCount) {
     for (auto& frame : frames) {
         frame.init(device);
     }
+
+    vk::SemaphoreTypeCreateInfo ti{vk::SemaphoreType::eTimeline, 0};
+    vk::SemaphoreCreateInfo si{};
+    si.setPNext(&ti);
+    timeline = {device, si};
+    submitted = 0;
+}
+
+void Frames::wait(const vk::raii::Device& device, uint64_t value) const {
+    vk::SemaphoreWaitInfo wi{};
+    wi.setSemaphores(*timeline);
+    wi.setValues(value);
+    if (auto result = device.waitSemaphores(wi, UINT64_MAX); result != vk::Result::eSuccess) {
+        throw std::runtime_error(std::format("Failed to wait for frame {}: {}", value, vk::to_string(result)));
+    }
+}
+
+uint64_t Frames::nextSignalValue() {
+    uint64_t value = submitted.load(std::memory_order_relaxed) + 1;
+    frames[currentFrame].submitValue = value;
+    submitted.store(value, std::memory_order_release);
+    return value;
 }
 
-}  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
+}  // namespace Solaris::Graphics::Vulkan
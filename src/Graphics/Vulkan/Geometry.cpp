@@ -0,0 +1,278 @@
+#include "Graphics/Vulkan/Geometry.hpp"
+#include "Graphics/Vulkan/Upload.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <numeric>
+#include <ranges>
+
+namespace Solaris::Graphics::Vulkan {
+
+constexpr vk::BufferUsageFlags arenaUsage = vk::BufferUsageFlagBits::eStorageBuffer |
+                                            vk::BufferUsageFlagBits::eTransferSrc |
+                                            vk::BufferUsageFlagBits::eTransferDst;
+
+void GeometryArena::init(vma::Allocator* _allocator,
+                         vma::Pool _pool,
+                         UploadManager& _uploads,
+                         DeletionQueue& _deletionQueue,
+                         const Config& _config) {
+    allocator = _allocator;
+    pool = _pool;
+    uploads = &_uploads;
+    deletionQueue = &_deletionQueue;
+    config = _config;
+    indexSize = GetIndexSize(config.indexType);
+    if (config.vertexStrides.empty() || std::ranges::find(config.vertexStrides, 0u) != config.vertexStrides.end()) {
+        throw std::runtime_error("Geometry arena needs at least one vertex stream of a nonzero stride");
+    }
+
+    // All are bound by handle at record time, never through descriptors, so the defragmenter may move them.
+    createBuffers(vertexBuffers, indexBuffer);
+    vertexRanges = OffsetAllocator(config.vertexCapacity);
+    indexRanges = OffsetAllocator(config.indexCapacity);
+
+    uint32_t vertexSize = std::accumulate(config.vertexStrides.begin(), config.vertexStrides.end(), 0u);
+    spdlog::info("Geometry arena: {} vertices of {} bytes in {} streams, {} indices.", config.vertexCapacity,
+                 vertexSize, config.vertexStrides.size(), config.indexCapacity);
+}
+
+void GeometryArena::createBuffers(std::vector<Buffer>& vertices, Buffer& indices) const {
+    vertices.resize(config.vertexStrides.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[i].initRelocatable(allocator, pool, vk::DeviceSize{config.vertexStrides[i]} * config.vertexCapacity,
+                                    arenaUsage | vk::BufferUsageFlagBits::eVertexBuffer, MemoryCategory::Geometry);
+    }
+    indices.initRelocatable(allocator, pool, vk::DeviceSize{indexSize} * config.indexCapacity,
+                            arenaUsage | vk::BufferUsageFlagBits::eIndexBuffer, MemoryCategory::Geometry);
+}
+
+MeshHandle GeometryArena::add(const MeshFile& mesh) {
+    auto streams = mesh.streams();
+    if (streams.size() != config.vertexStrides.size()) {
+        throw std::runtime_error(std::format("Mesh has {} vertex streams, the arena {}", streams.size(),
+                                             config.vertexStrides.size()));
+    }
+    std::vector<const void*> data(streams.size());
+    for (uint32_t i = 0; i < streams.size(); i++) {
+        if (streams[i].stride != config.vertexStrides[i]) {
+            throw std::runtime_error(std::format("Mesh stream {} has a stride of {} bytes, the arena's {}", i,
+                                                 streams[i].stride, config.vertexStrides[i]));
+        }
+        data[i] = mesh.streamBytes(i).data();
+    }
+
+    if (mesh.indexSize() == indexSize) {
+        return add(data, mesh.vertexCount(), mesh.indexBytes().data(), mesh.indexCount(), mesh.lods());
+    }
+    std::vector<uint32_t> widened;
+    auto widen = [&](auto indices) { widened.assign(indices.begin(), indices.end()); };
+    if (mesh.indexSize() == 1) {
+        widen(mesh.indices<uint8_t>());
+    } else if (mesh.indexSize() == 2) {
+        widen(mesh.indices<uint16_t>());
+    } else {
+        widen(mesh.indices<uint32_t>());
+    }
+    return addConverted(data, mesh.vertexCount(), widened, mesh.lods());
+}
+
+MeshHandle GeometryArena::add(std::span<const void* const> streams,
+                              uint32_t vertexCount,
+                              const void* indices,
+                              uint32_t indexCount,
+                              std::span<const MeshLod> lods) {
+    if (vertexCount == 0 || indexCount == 0) {
+        throw std::runtime_error(std::format("Mesh of {} vertices and {} indices is empty, nothing to draw",
+                                             vertexCount, indexCount));
+    }
+    if (lods.size() > kMaxMeshLods) {
+        throw std::runtime_error(std::format("Mesh has {} levels of detail, at most {} are supported", lods.size(),
+                                             kMaxMeshLods));
+    }
+    for (const auto& lod : lods) {
+        if (uint64_t{lod.firstIndex} + lod.indexCount > indexCount) {
+            throw std::runtime_error("Mesh level of detail is past the end of its indices");
+        }
+    }
+
+    auto vertexAlloc = vertexRanges.allocate(vertexCount);
+    auto indexAlloc = indexRanges.allocate(indexCount);
+    if (!vertexAlloc.isValid() || !indexAlloc.isValid()) {
+        vertexRanges.free(vertexAlloc);
+        indexRanges.free(indexAlloc);
+        throw std::runtime_error(std::format("Geometry arena is out of space for a mesh of {} vertices, {} indices",
+                                             vertexCount, indexCount));
+    }
+
+    for (size_t i = 0; i < vertexBuffers.size(); i++) {
+        vk::DeviceSize stride = config.vertexStrides[i];
+        uploads->upload(vertexBuffers[i], streams[i], vertexCount * stride, vertexAlloc.offset * stride);
+    }
+    uploads->upload(indexBuffer, indices, vk::DeviceSize{indexCount} * indexSize,
+                    vk::DeviceSize{indexAlloc.offset} * indexSize);
+
+    uint32_t id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = static_cast<uint32_t>(meshes.size());
+        meshes.emplace_back();
+    }
+    auto& mesh = meshes[id];
+    mesh = {vertexAlloc, indexAlloc, vertexCount, indexCount, true};
+    if (lods.empty()) {
+        mesh.lods[0] = {0, indexCount, 0.0f, 0};
+        mesh.lodCount = 1;
+    } else {
+        std::ranges::copy(lods, mesh.lods.begin());
+        mesh.lodCount = static_cast<uint32_t>(lods.size());
+    }
+    return {id};
+}
+
+MeshHandle GeometryArena::addConverted(std::span<const void* const> streams,
+                                       uint32_t vertexCount,
+                                       std::span<const uint32_t> indices,
+                                       std::span<const MeshLod> lods) {
+    uint32_t limit = indexSize == 4 ? UINT32_MAX : (1u << (8 * indexSize)) - 1;
+    if (!indices.empty() && std::ranges::max(indices) > limit) {
+        throw std::runtime_error(std::format("Mesh of {} vertices does not fit the arena's {} indices", vertexCount,
+                                             vk::to_string(config.indexType)));
+    }
+
+    std::vector<std::byte> packed(indices.size() * indexSize);
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (indexSize == 1) {
+            packed[i] = static_cast<std::byte>(indices[i]);
+        } else if (indexSize == 2) {
+            auto index = static_cast<uint16_t>(indices[i]);
+            std::memcpy(&packed[i * 2], &index, 2);
+        } else {
+            std::memcpy(&packed[i * 4], &indices[i], 4);
+        }
+    }
+    return add(streams, vertexCount, packed.data(), static_cast<uint32_t>(indices.size()), lods);
+}
+
+void GeometryArena::remove(MeshHandle mesh) {
+    if (!mesh.isValid() || !meshes[mesh.id].alive) {
+        return;
+    }
+
+    auto& entry = meshes[mesh.id];
+    // Frames in flight may still draw from these ranges.
+    pendingFrees++;
+    deletionQueue->defer([this, vertices = entry.vertices, indices = entry.indices] {
+        vertexRanges.free(vertices);
+        indexRanges.free(indices);
+        pendingFrees--;
+    });
+    entry = {};
+    freeIds.push_back(mesh.id);
+}
+
+MeshRange GeometryArena::getRange(MeshHandle mesh, uint32_t lod) const {
+    const auto& entry = meshes[mesh.id];
+    const auto& range = entry.lods[std::min(lod, entry.lodCount - 1)];
+    return {entry.indices.offset + range.firstIndex, range.indexCount, static_cast<int32_t>(entry.vertices.offset)};
+}
+
+std::span<const MeshLod> GeometryArena::getLods(MeshHandle mesh) const {
+    const auto& entry = meshes[mesh.id];
+    return std::span(entry.lods).first(entry.lodCount);
+}
+
+float GeometryArena::getFragmentation() const {
+    return std::max(vertexRanges.report().fragmentation(), indexRanges.report().fragmentation());
+}
+
+void GeometryArena::update(const vk::raii::CommandBuffer& cmd) {
+    // Only worth it once enough has been freed; a nearly full arena has little to gain.
+    if (pendingFrees == 0 && getFragmentation() > config.compactionThreshold) {
+        compact(cmd);
+    }
+}
+
+void GeometryArena::compact(const vk::raii::CommandBuffer& cmd) {
+    // Pending uploads target the current buffers. Submitting them now makes the frame wait for them, so the
+    // copies below see their data.
+    uploads->flush();
+
+    std::vector<Buffer> packedVertices;
+    Buffer packedIndices;
+    createBuffers(packedVertices, packedIndices);
+
+    // A fresh allocator hands out ranges front to back, which packs the meshes without gaps. The vertex copies
+    // are in vertices, scaled by each stream's stride below.
+    OffsetAllocator packedVertexRanges(config.vertexCapacity);
+    OffsetAllocator packedIndexRanges(config.indexCapacity);
+    std::vector<vk::BufferCopy> vertexCopies;
+    std::vector<vk::BufferCopy> indexCopies;
+
+    for (auto& mesh : meshes) {
+        if (!mesh.alive) {
+            continue;
+        }
+        auto vertices = packedVertexRanges.allocate(mesh.vertexCount);
+        auto indices = packedIndexRanges.allocate(mesh.indexCount);
+        vertexCopies.push_back({mesh.vertices.offset, vertices.offset, mesh.vertexCount});
+        indexCopies.push_back({vk::DeviceSize{mesh.indices.offset} * indexSize,
+                               vk::DeviceSize{indices.offset} * indexSize,
+                               vk::DeviceSize{mesh.indexCount} * indexSize});
+        mesh.vertices = vertices;
+        mesh.indices = indices;
+    }
+
+    if (!vertexCopies.empty()) {
+        for (size_t i = 0; i < vertexBuffers.size(); i++) {
+            vk::DeviceSize stride = config.vertexStrides[i];
+            std::vector<vk::BufferCopy> copies(vertexCopies);
+            for (auto& copy : copies) {
+                copy = {copy.srcOffset * stride, copy.dstOffset * stride, copy.size * stride};
+            }
+            cmd.copyBuffer(vertexBuffers[i].getBuffer(), packedVertices[i].getBuffer(), copies);
+        }
+        cmd.copyBuffer(indexBuffer.getBuffer(), packedIndices.getBuffer(), indexCopies);
+    }
+
+    vk::MemoryBarrier barrier{vk::AccessFlagBits::eTransferWrite,
+                              vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+                                  vk::AccessFlagBits::eShaderRead};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                        vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader |
+                            vk::PipelineStageFlagBits::eComputeShader,
+                        {}, barrier, {}, {});
+
+    float before = getFragmentation();
+    deletionQueue->retire(std::move(vertexBuffers));
+    deletionQueue->retire(std::move(indexBuffer));
+    vertexBuffers = std::move(packedVertices);
+    indexBuffer = std::move(packedIndices);
+    vertexRanges = std::move(packedVertexRanges);
+    indexRanges = std::move(packedIndexRanges);
+    generation++;
+
+    spdlog::info("Compacted geometry arena, fragmentation {:.2f} -> {:.2f}.", before, getFragmentation());
+}
+
+void GeometryArena::bind(const vk::raii::CommandBuffer& cmd, uint32_t streamCount) const {
+    std::vector<vk::Buffer> buffers;
+    for (const auto& buffer : vertexBuffers | std::views::take(streamCount)) {
+        buffers.push_back(buffer.getBuffer());
+    }
+    std::vector<vk::DeviceSize> offsets(buffers.size(), 0);
+    cmd.bindVertexBuffers(0, buffers, offsets);
+    cmd.bindIndexBuffer(indexBuffer.getBuffer(), 0, config.indexType);
+}
+
+void GeometryArena::draw(const vk::raii::CommandBuffer& cmd, MeshHandle mesh, uint32_t instanceCount) const {
+    auto range = getRange(mesh);
+    cmd.drawIndexed(range.indexCount, instanceCount, range.firstIndex, range.vertexOffset, 0);
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,51 @@
+#include "Graphics/Vulkan/Image.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_structs.hpp>
+
+namespace Solaris::Graphics::Vulkan {
+
+void Image::init(vma::Allocator* _allocator,
+                 vk::Extent2D _extent,
+                 vk::Format _format,
+                 vk::ImageUsageFlags usage,
+                 MemoryCategory _category) {
+    allocator = _allocator;
+    format = _format;
+    extent = _extent;
+    category = _category;
+
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo.setImageType(vk::ImageType::e2D);
+    imageInfo.setFormat(format);
+    imageInfo.setExtent({extent.width, extent.height, 1});
+    imageInfo.setMipLevels(1);
+    imageInfo.setArrayLayers(1);
+    imageInfo.setSamples(vk::SampleCountFlagBits::e1);
+    imageInfo.setTiling(vk::ImageTiling::eOptimal);
+    imageInfo.setUsage(usage);
+    imageInfo.setSharingMode(vk::SharingMode::eExclusive);
+    imageInfo.setInitialLayout(vk::ImageLayout::eUndefined);
+
+    vma::AllocationCreateInfo allocCreateInfo{};
+    allocCreateInfo.usage = vma::MemoryUsage::eAutoPreferDevice;
+
+    vma::AllocationInfo allocInfo{};
+    auto [image, alloc] = allocator->createImage(imageInfo, allocCreateInfo, allocInfo);
+    _image = image;
+    allocation = alloc;
+    size = allocInfo.size;
+    trackAllocation(*allocator, allocation, category, size);
+}
+
+void Image::destroy() {
+    if (_image) {
+        untrackAllocation(category, size);
+        allocator->destroyImage(_image, allocation);
+        _image = VK_NULL_HANDLE;
+        allocation = nullptr;
+    }
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,170 @@
+#include "Graphics/Vulkan/Memory.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace Solaris::Graphics::Vulkan {
+
+namespace {
+
+struct CategoryCounters {
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint32_t> count{0};
+};
+
+std::array<CategoryCounters, kMemoryCategoryCount> categoryCounters{};
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+}  // namespace
+
+std::string_view getCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Geometry:
+            return "Geometry";
+        case MemoryCategory::Staging:
+            return "Staging";
+        case MemoryCategory::PerFrame:
+            return "PerFrame";
+        case MemoryCategory::Textures:
+            return "Textures";
+        case MemoryCategory::RenderTargets:
+            return "RenderTargets";
+        case MemoryCategory::Other:
+            return "Other";
+    }
+    return "Unknown";
+}
+
+void trackAllocation(const vma::Allocator& allocator,
+                     vma::Allocation allocation,
+                     MemoryCategory category,
+                     vk::DeviceSize size) {
+    // The names are string literals, so the pointer handed to VMA stays valid.
+    allocator.setAllocationName(allocation, getCategoryName(category).data());
+
+    auto& counters = categoryCounters[static_cast<size_t>(category)];
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void untrackAllocation(MemoryCategory category, vk::DeviceSize size) {
+    auto& counters = categoryCounters[static_cast<size_t>(category)];
+    counters.bytes.fetch_sub(size, std::memory_order_relaxed);
+    counters.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+float HeapReport::getPressure() const {
+    return budget > 0 ? static_cast<float>(usage) / static_cast<float>(budget) : 0.0f;
+}
+
+float HeapReport::getFragmentation() const {
+    return blockBytes > 0 ? 1.0f - static_cast<float>(allocationBytes) / static_cast<float>(blockBytes) : 0.0f;
+}
+
+void MemoryTracker::init(const vma::Allocator& _allocator,
+                         const vk::raii::PhysicalDevice& physicalDevice,
+                         bool memoryBudget) {
+    allocator = &_allocator;
+    budgetExtension = memoryBudget;
+
+    auto properties = physicalDevice.getMemoryProperties();
+    heapFlags.clear();
+    for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+        heapFlags.push_back(properties.memoryHeaps[i].flags);
+    }
+    report.heaps.assign(heapFlags.size(), {});
+    peaks.assign(heapFlags.size(), {});
+    overBudget.assign(heapFlags.size(), false);
+
+    if (!budgetExtension) {
+        spdlog::info("VK_EXT_memory_budget not available, memory budgets are estimated from heap sizes.");
+    }
+}
+
+void MemoryTracker::setBudgetCallback(float _threshold, BudgetCallback callback) {
+    threshold = _threshold;
+    budgetCallback = std::move(callback);
+}
+
+void MemoryTracker::update() {
+    // VMA refreshes its budgets from VK_EXT_memory_budget when the frame index changes.
+    allocator->setCurrentFrameIndex(static_cast<uint32_t>(++frame));
+
+    std::array<vma::Budget, VK_MAX_MEMORY_HEAPS> budgets{};
+    allocator->getHeapBudgets(budgets.data());
+
+    for (size_t i = 0; i < report.heaps.size(); i++) {
+        auto& heap = report.heaps[i];
+        heap.usage = budgets[i].usage;
+        heap.budget = budgets[i].budget;
+        heap.blockBytes = budgets[i].statistics.blockBytes;
+        heap.allocationBytes = budgets[i].statistics.allocationBytes;
+        heap.blockCount = budgets[i].statistics.blockCount;
+        heap.allocationCount = budgets[i].statistics.allocationCount;
+        heap.deviceLocal = static_cast<bool>(heapFlags[i] & vk::MemoryHeapFlagBits::eDeviceLocal);
+
+        if (heap.usage > peaks[i].usage) {
+            peaks[i] = heap;
+        }
+    }
+
+    for (size_t i = 0; i < kMemoryCategoryCount; i++) {
+        report.categories[i].bytes = categoryCounters[i].bytes.load(std::memory_order_relaxed);
+        report.categories[i].allocationCount = categoryCounters[i].count.load(std::memory_order_relaxed);
+    }
+
+    for (uint32_t i = 0; i < report.heaps.size(); i++) {
+        const auto& heap = report.heaps[i];
+        bool over = heap.getPressure() >= threshold;
+        if (over && !overBudget[i]) {
+            spdlog::warn("Memory heap {} at {:.0f}% of its budget ({:.1f} of {:.1f} MiB).", i,
+                         heap.getPressure() * 100.0f, static_cast<double>(heap.usage) / kMiB,
+                         static_cast<double>(heap.budget) / kMiB);
+        }
+        overBudget[i] = over;
+        if (over && budgetCallback) {
+            budgetCallback(i, report);
+        }
+    }
+}
+
+void MemoryTracker::dumpJson(const std::filesystem::path& path) const {
+    char* stats = nullptr;
+    allocator->buildStatsString(&stats, vk::True);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (file) {
+        file << stats;
+    }
+    allocator->freeStatsString(stats);
+
+    if (!file) {
+        throw std::runtime_error(std::format("Failed to write memory statistics to {}", path.string()));
+    }
+    spdlog::info("Memory statistics written to {}.", path.string());
+}
+
+void MemoryTracker::logSummary() const {
+    spdlog::info("Memory{}:", budgetExtension ? "" : " (estimated budgets)");
+    for (size_t i = 0; i < report.heaps.size(); i++) {
+        const auto& heap = report.heaps[i];
+        spdlog::info("  heap {}{}: {:8.1f} of {:8.1f} MiB, peak {:8.1f} MiB, {:>5} allocations in {:>3} blocks, "
+                     "{:4.1f}% fragmented",
+                     i, heap.deviceLocal ? " (device)" : " (host)  ", static_cast<double>(heap.usage) / kMiB,
+                     static_cast<double>(heap.budget) / kMiB, static_cast<double>(peaks[i].usage) / kMiB,
+                     heap.allocationCount, heap.blockCount, heap.getFragmentation() * 100.0f);
+    }
+    for (size_t i = 0; i < kMemoryCategoryCount; i++) {
+        const auto& category = report.categories[i];
+        spdlog::info("  {:<13} {:8.1f} MiB in {:>5} allocations", getCategoryName(static_cast<MemoryCategory>(i)),
+                     static_cast<double>(category.bytes) / kMiB, category.allocationCount);
+    }
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,416 @@
+#include "Graphics/Vulkan/Pipeline.hpp"
+#include "Core/Hash.hpp"
+#include "Graphics/Vulkan/Shader.hpp"
+
+#include <spdlog/spdlog.h>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vulkan/vulkan_structs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <span>
+
+namespace Solaris::Graphics::Vulkan {
+
+// On-disk layout: this header followed by the driver's cache blob.
+struct PipelineCacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t cacheUUID[VK_UUID_SIZE];
+    uint32_t reserved;
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+constexpr uint32_t pipelineCacheMagic = 0x43505053;  // "SPPC"
+constexpr uint32_t pipelineCacheVersion = 1;
+
+bool ShaderStageDesc::operator==(const ShaderStageDesc& other) const {
+    if (stage != other.stage || entryPoint != other.entryPoint) {
+        return false;
+    }
+    if (codeHash != 0 && other.codeHash != 0) {
+        return codeHash == other.codeHash;
+    }
+    return module == other.module;
+}
+
+uint64_t GraphicsPipelineDesc::hash() const {
+    uint64_t h = kFnvOffsetBasis;
+    for (const auto& stage : stages) {
+        h = HashValue(stage.stage, h);
+        h = stage.codeHash != 0 ? HashValue(stage.codeHash, h)
+                                : HashValue(reinterpret_cast<uint64_t>(static_cast<VkShaderModule>(stage.module)), h);
+        h = Fnv1a(stage.entryPoint.data(), stage.entryPoint.size(), h);
+    }
+
+    h = HashRange(std::span(vertexBindings), h);
+    h = HashRange(std::span(vertexAttributes), h);
+    h = HashValue(topology, h);
+
+    h = HashValue(polygonMode, h);
+    h = HashValue(static_cast<VkCullModeFlags>(cullMode), h);
+    h = HashValue(frontFace, h);
+    h = HashValue(lineWidth, h);
+    h = HashValue(samples, h);
+
+    h = HashValue(depthTest, h);
+    h = HashValue(depthWrite, h);
+    h = HashValue(depthCompare, h);
+
+    h = HashRange(std::span(blendAttachments), h);
+    h = HashRange(std::span(dynamicStates), h);
+
+    h = HashValue(reinterpret_cast<uint64_t>(static_cast<VkPipelineLayout>(layout)), h);
+    h = HashValue(reinterpret_cast<uint64_t>(static_cast<VkRenderPass>(renderPass)), h);
+    h = HashValue(subpass, h);
+    return h;
+}
+
+void PipelineRegistry::init(const vk::raii::Device& _device,
+                            const vk::raii::PhysicalDevice& physicalDevice,
+                            std::filesystem::path _cachePath,
+                            DeletionQueue& _deletionQueue,
+                            size_t workerCount) {
+    device = &_device;
+    cachePath = std::move(_cachePath);
+    deletionQueue = &_deletionQueue;
+
+    auto properties = physicalDevice.getProperties();
+    vendorID = properties.vendorID;
+    deviceID = properties.deviceID;
+    driverVersion = properties.driverVersion;
+    std::copy(properties.pipelineCacheUUID.begin(), properties.pipelineCacheUUID.end(), cacheUUID.begin());
+
+    auto data = loadCacheData();
+    vk::PipelineCacheCreateInfo ci{};
+    ci.setInitialDataSize(data.size());
+    ci.setPInitialData(data.empty() ? nullptr : data.data());
+    cache = {*device, ci};
+
+    workers = std::make_unique<ThreadPool>(workerCount);
+    spdlog::info("Pipeline registry compiling on {} worker threads.", workers->size());
+}
+
+std::vector<uint8_t> PipelineRegistry::loadCacheData() const {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) {
+        spdlog::info("No pipeline cache at {}, starting cold.", cachePath.string());
+        return {};
+    }
+
+    PipelineCacheFileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != pipelineCacheMagic ||
+        header.version != pipelineCacheVersion) {
+        spdlog::warn("Ignoring pipeline cache {}: unrecognized file.", cachePath.string());
+        return {};
+    }
+
+    if (header.vendorID != vendorID || header.deviceID != deviceID || header.driverVersion != driverVersion ||
+        std::memcmp(header.cacheUUID, cacheUUID.data(), VK_UUID_SIZE) != 0) {
+        spdlog::info("Ignoring pipeline cache {}: written by a different device or driver.", cachePath.string());
+        return {};
+    }
+
+    std::vector<uint8_t> data(header.dataSize);
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())) ||
+        Fnv1a(data.data(), data.size()) != header.dataHash) {
+        spdlog::warn("Ignoring pipeline cache {}: truncated or corrupt.", cachePath.string());
+        return {};
+    }
+
+    spdlog::info("Loaded pipeline cache {} ({} KiB).", cachePath.string(), data.size() / 1024);
+    return data;
+}
+
+void PipelineRegistry::wait() const {
+    std::vector<std::shared_future<vk::Pipeline>> pending;
+    {
+        std::lock_guard lock(mutex);
+        for (const auto& [hash, bucket] : pipelines) {
+            for (const auto& entry : bucket) {
+                pending.push_back(entry->ready);
+            }
+        }
+    }
+    for (const auto& future : pending) {
+        future.wait();
+    }
+}
+
+size_t PipelineRegistry::size() const {
+    std::lock_guard lock(mutex);
+    return count;
+}
+
+void PipelineRegistry::save() const {
+    if (!*cache) {
+        return;
+    }
+
+    wait();
+    auto data = cache.getData();
+
+    PipelineCacheFileHeader header{};
+    header.magic = pipelineCacheMagic;
+    header.version = pipelineCacheVersion;
+    header.vendorID = vendorID;
+    header.deviceID = deviceID;
+    header.driverVersion = driverVersion;
+    std::memcpy(header.cacheUUID, cacheUUID.data(), VK_UUID_SIZE);
+    header.dataSize = data.size();
+    header.dataHash = Fnv1a(data.data(), data.size());
+
+    // Write next to the target and rename, so a crash mid-write never leaves a half-written cache behind.
+    auto tmpPath = cachePath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            spdlog::warn("Failed to write pipeline cache {}.", tmpPath.string());
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        spdlog::warn("Failed to write pipeline cache {}: {}", cachePath.string(), ec.message());
+        return;
+    }
+    spdlog::info("Saved pipeline cache {} ({} KiB, {} pipelines, {} reused).", cachePath.string(),
+                 data.size() / 1024, count, hits);
+}
+
+PipelineRegistry::Entry& PipelineRegistry::findOrCreate(const GraphicsPipelineDesc& desc) {
+    auto& bucket = pipelines[desc.hash()];
+    for (const auto& entry : bucket) {
+        if (entry->desc == desc) {
+            hits++;
+            return *entry;
+        }
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->desc = desc;
+    // Entries are heap allocated and never erased, so the worker can fill this one in without the lock.
+    Entry* target = entry.get();
+    entry->ready = workers
+                       ->submit([this, target] {
+                           target->pipeline = compile(target->desc);
+                           target->current.store(*target->pipeline, std::memory_order_release);
+                           return *target->pipeline;
+                       })
+                       .share();
+
+    bucket.push_back(std::move(entry));
+    count++;
+    return *bucket.back();
+}
+
+std::shared_future<vk::Pipeline> PipelineRegistry::getAsync(const GraphicsPipelineDesc& desc) {
+    std::lock_guard lock(mutex);
+    return findOrCreate(desc).ready;
+}
+
+PipelineHandle PipelineRegistry::getHandle(const GraphicsPipelineDesc& desc) {
+    std::lock_guard lock(mutex);
+    return PipelineHandle(&findOrCreate(desc).current);
+}
+
+void PipelineRegistry::reload(std::span<const std::string> paths, ShaderRegistry& shaders) {
+    if (paths.empty()) {
+        return;
+    }
+
+    std::lock_guard lock(mutex);
+    for (auto& [hash, bucket] : pipelines) {
+        for (auto& entry : bucket) {
+            bool affected = std::ranges::any_of(entry->desc.stages, [&](const ShaderStageDesc& stage) {
+                return std::ranges::find(paths, stage.path) != paths.end();
+            });
+            if (!affected) {
+                continue;
+            }
+
+            if (!entry->rebuild.valid()) {
+                rebuilding.push_back(entry.get());
+            }
+
+            // Starts from the latest description, an earlier rebuild of the entry may still be running.
+            GraphicsPipelineDesc desc = entry->pendingDesc.stages.empty() ? entry->desc : entry->pendingDesc;
+            for (auto& stage : desc.stages) {
+                if (std::ranges::find(paths, stage.path) != paths.end()) {
+                    stage = shaders.load(stage.path, stage.stage, stage.entryPoint);
+                }
+            }
+            entry->pendingDesc = desc;
+
+            // The worker lets the first build and any earlier rebuild finish before writing the same entry, so
+            // the frame thread never waits on a compile.
+            Entry* target = entry.get();
+            entry->rebuild = workers
+                                 ->submit([this, target, desc = std::move(desc), first = entry->ready,
+                                           previous = entry->rebuild] {
+                                     first.wait();
+                                     if (previous.valid()) {
+                                         previous.wait();
+                                     }
+                                     target->pending = compile(desc);
+                                 })
+                                 .share();
+        }
+    }
+
+    // Any build already started or queued may have been described with a retired module, including the rebuilds
+    // just submitted, which wait for the ones before them.
+    auto modules = shaders.takeRetired();
+    if (modules.empty()) {
+        return;
+    }
+    RetiredModules retired{std::move(modules), {}, {}};
+    for (auto& [hash, bucket] : pipelines) {
+        for (auto& entry : bucket) {
+            if (entry->ready.valid()) {
+                retired.builds.push_back(entry->ready);
+            }
+            if (entry->rebuild.valid()) {
+                retired.rebuilds.push_back(entry->rebuild);
+            }
+        }
+    }
+    retiredModules.push_back(std::move(retired));
+}
+
+void PipelineRegistry::update() {
+    std::erase_if(rebuilding, [&](Entry* entry) {
+        if (entry->rebuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return false;
+        }
+
+        try {
+            entry->rebuild.get();
+        } catch (std::exception& err) {
+            // Keep drawing with the old pipeline until the shader is fixed.
+            spdlog::warn("Failed to rebuild pipeline: {}", err.what());
+            entry->pendingDesc = {};
+            entry->rebuild = {};
+            return true;
+        }
+
+        std::lock_guard lock(mutex);
+        // The description changed, so move the entry to the bucket for its new hash.
+        auto& oldBucket = pipelines[entry->desc.hash()];
+        auto it = std::ranges::find_if(oldBucket, [&](const auto& e) { return e.get() == entry; });
+        auto owned = std::move(*it);
+        oldBucket.erase(it);
+        pipelines[entry->pendingDesc.hash()].push_back(std::move(owned));
+
+        // Frames still in flight may have recorded the old pipeline.
+        deletionQueue->retire(std::move(entry->pipeline));
+        entry->pipeline = std::move(entry->pending);
+        entry->desc = std::move(entry->pendingDesc);
+        entry->pendingDesc = {};
+        entry->rebuild = {};
+        entry->current.store(*entry->pipeline, std::memory_order_release);
+        std::promise<vk::Pipeline> rebuilt;
+        rebuilt.set_value(*entry->pipeline);
+        entry->ready = rebuilt.get_future().share();
+        return true;
+    });
+
+    // A pipeline does not refer to its modules once created, so they can go as soon as their builds are done.
+    auto done = [](const auto& future) {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    std::erase_if(retiredModules, [&](const RetiredModules& retired) {
+        return std::ranges::all_of(retired.builds, done) && std::ranges::all_of(retired.rebuilds, done);
+    });
+}
+
+std::vector<std::shared_future<vk::Pipeline>> PipelineRegistry::build(std::span<const GraphicsPipelineDesc> descs) {
+    std::vector<std::shared_future<vk::Pipeline>> futures;
+    futures.reserve(descs.size());
+    for (const auto& desc : descs) {
+        futures.push_back(getAsync(desc));
+    }
+    return futures;
+}
+
+vk::raii::Pipeline PipelineRegistry::compile(const GraphicsPipelineDesc& desc) const {
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
+    shaderStages.reserve(desc.stages.size());
+    for (const auto& stage : desc.stages) {
+        vk::PipelineShaderStageCreateInfo si{};
+        si.setStage(stage.stage);
+        si.setModule(stage.module);
+        si.setPName(stage.entryPoint.c_str());
+        shaderStages.push_back(si);
+    }
+
+    vk::PipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.setDynamicStates(desc.dynamicStates);
+
+    vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.setVertexBindingDescriptions(desc.vertexBindings);
+    vertexInputInfo.setVertexAttributeDescriptions(desc.vertexAttributes);
+
+    vk::PipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.topology = desc.topology;
+    inputAssembly.primitiveRestartEnable = vk::False;
+
+    vk::PipelineViewportStateCreateInfo viewportState{};
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    vk::PipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.depthClampEnable = vk::False;
+    rasterizer.rasterizerDiscardEnable = vk::False;
+    rasterizer.polygonMode = desc.polygonMode;
+    rasterizer.lineWidth = desc.lineWidth;
+    rasterizer.cullMode = desc.cullMode;
+    rasterizer.frontFace = desc.frontFace;
+    rasterizer.depthBiasEnable = vk::False;
+
+    vk::PipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sampleShadingEnable = vk::False;
+    multisampling.rasterizationSamples = desc.samples;
+
+    vk::PipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.depthTestEnable = desc.depthTest ? vk::True : vk::False;
+    depthStencil.depthWriteEnable = desc.depthWrite ? vk::True : vk::False;
+    depthStencil.depthCompareOp = desc.depthCompare;
+
+    vk::PipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.logicOpEnable = vk::False;
+    colorBlending.logicOp = vk::LogicOp::eCopy;
+    colorBlending.setAttachments(desc.blendAttachments);
+
+    vk::GraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.setStages(shaderStages);
+    pipelineInfo.setPVertexInputState(&vertexInputInfo);
+    pipelineInfo.setPInputAssemblyState(&inputAssembly);
+    pipelineInfo.setPViewportState(&viewportState);
+    pipelineInfo.setPRasterizationState(&rasterizer);
+    pipelineInfo.setPMultisampleState(&multisampling);
+    pipelineInfo.setPDepthStencilState(desc.depthTest || desc.depthWrite ? &depthStencil : nullptr);
+    pipelineInfo.setPColorBlendState(&colorBlending);
+    pipelineInfo.setPDynamicState(&dynamicState);
+    pipelineInfo.setLayout(desc.layout);
+    pipelineInfo.setRenderPass(desc.renderPass);
+    pipelineInfo.setSubpass(desc.subpass);
+    pipelineInfo.setBasePipelineHandle(VK_NULL_HANDLE);
+    pipelineInfo.setBasePipelineIndex(-1);
+
+    return device->createGraphicsPipeline(cache, pipelineInfo);
+}
+
+}  // namespace Solaris::Graphics::Vulkan
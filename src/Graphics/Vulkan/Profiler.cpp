@@ -0,0 +1,219 @@
+#include "Graphics/Vulkan/Profiler.hpp"
+
+#include <spdlog/spdlog.h>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vulkan/vulkan_structs.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace Solaris::Graphics::Vulkan {
+
+const vk::QueryPipelineStatisticFlags pipelineStatisticFlags =
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingInvocations | vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations;
+constexpr uint32_t pipelineStatisticCount = 6;
+
+void GpuProfiler::init(const vk::raii::Device& device,
+                       const vk::raii::PhysicalDevice& physicalDevice,
+                       uint32_t queueFamily,
+                       size_t frameCount,
+                       bool pipelineStatistics) {
+    auto validBits = physicalDevice.getQueueFamilyProperties()[queueFamily].timestampValidBits;
+    if (validBits == 0) {
+        spdlog::warn("Queue family {} does not support timestamps, GPU profiler disabled.", queueFamily);
+        return;
+    }
+
+    enabled = true;
+    statisticsEnabled = pipelineStatistics;
+    timestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+    timestampMask = validBits >= 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t{1} << validBits) - 1;
+
+    frames.clear();
+    frames.resize(frameCount);
+    for (auto& frame : frames) {
+        vk::QueryPoolCreateInfo ti{{}, vk::QueryType::eTimestamp, kMaxScopes * 2};
+        frame.timestamps = {device, ti};
+
+        if (statisticsEnabled) {
+            vk::QueryPoolCreateInfo si{{}, vk::QueryType::ePipelineStatistics, 1, pipelineStatisticFlags};
+            frame.statistics = {device, si};
+        }
+    }
+
+    spdlog::info("GPU profiler enabled ({} frames, {} scopes per frame, pipeline statistics {}).", frameCount,
+                 kMaxScopes, statisticsEnabled ? "on" : "off");
+}
+
+void GpuProfiler::beginFrame(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex) {
+    if (!enabled) {
+        return;
+    }
+
+    current = &frames[frameIndex];
+    collect(*current);
+
+    cmd.resetQueryPool(current->timestamps, 0, kMaxScopes * 2);
+    if (statisticsEnabled) {
+        cmd.resetQueryPool(current->statistics, 0, 1);
+    }
+    current->scopeIds.clear();
+    current->statisticsWritten = false;
+}
+
+uint32_t GpuProfiler::beginScope(const vk::raii::CommandBuffer& cmd,
+                                 std::string_view name,
+                                 vk::PipelineStageFlagBits stage) {
+    if (!enabled || current == nullptr || current->scopeIds.size() >= kMaxScopes) {
+        return kInvalidScope;
+    }
+
+    auto [it, inserted] = scopeLookup.try_emplace(std::string(name), static_cast<uint32_t>(scopes.size()));
+    if (inserted) {
+        scopes.push_back({std::string(name), {}, 0, 0});
+        scopes.back().samples.reserve(kHistory);
+    }
+
+    auto slot = static_cast<uint32_t>(current->scopeIds.size());
+    current->scopeIds.push_back(it->second);
+    cmd.writeTimestamp(stage, current->timestamps, slot * 2);
+    return slot;
+}
+
+void GpuProfiler::endScope(const vk::raii::CommandBuffer& cmd, uint32_t scope, vk::PipelineStageFlagBits stage) {
+    if (scope == kInvalidScope || current == nullptr) {
+        return;
+    }
+    cmd.writeTimestamp(stage, current->timestamps, scope * 2 + 1);
+}
+
+void GpuProfiler::beginPipelineStatistics(const vk::raii::CommandBuffer& cmd) {
+    if (!enabled || !statisticsEnabled || current == nullptr) {
+        return;
+    }
+    cmd.beginQuery(current->statistics, 0, {});
+    current->statisticsWritten = true;
+}
+
+void GpuProfiler::endPipelineStatistics(const vk::raii::CommandBuffer& cmd) {
+    if (current == nullptr || !current->statisticsWritten) {
+        return;
+    }
+    cmd.endQuery(current->statistics, 0);
+}
+
+void GpuProfiler::collectPending() {
+    if (!enabled || current == nullptr) {
+        return;
+    }
+    // The slot after the current one was recorded longest ago.
+    size_t newest = static_cast<size_t>(current - frames.data());
+    for (size_t i = 1; i <= frames.size(); i++) {
+        auto& queries = frames[(newest + i) % frames.size()];
+        collect(queries);
+        queries.scopeIds.clear();
+        queries.statisticsWritten = false;
+    }
+}
+
+void GpuProfiler::collect(FrameQueries& queries) {
+    if (!queries.scopeIds.empty()) {
+        auto count = static_cast<uint32_t>(queries.scopeIds.size() * 2);
+        auto [result, ticks] = queries.timestamps.getResults<uint64_t>(0, count, count * sizeof(uint64_t),
+                                                                      sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+        // The frame has already been waited on, so eNotReady only happens for scopes that were never closed.
+        if (result == vk::Result::eSuccess) {
+            for (size_t i = 0; i < queries.scopeIds.size(); i++) {
+                uint64_t begin = ticks[i * 2] & timestampMask;
+                uint64_t end = ticks[i * 2 + 1] & timestampMask;
+                double ms = static_cast<double>((end - begin) & timestampMask) * timestampPeriod / 1e6;
+
+                auto& history = scopes[queries.scopeIds[i]];
+                if (history.samples.size() < kHistory) {
+                    history.samples.push_back(ms);
+                } else {
+                    history.samples[history.next] = ms;
+                }
+                history.next = (history.next + 1) % kHistory;
+                history.total++;
+            }
+        }
+    }
+
+    if (queries.statisticsWritten) {
+        auto [result, values] = queries.statistics.getResults<uint64_t>(
+            0, 1, pipelineStatisticCount * sizeof(uint64_t), pipelineStatisticCount * sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+        if (result == vk::Result::eSuccess) {
+            statistics.inputAssemblyVertices = values[0];
+            statistics.inputAssemblyPrimitives = values[1];
+            statistics.vertexShaderInvocations = values[2];
+            statistics.clippingInvocations = values[3];
+            statistics.clippingPrimitives = values[4];
+            statistics.fragmentShaderInvocations = values[5];
+        }
+    }
+}
+
+ScopeStats GpuProfiler::summarize(const ScopeHistory& history) const {
+    ScopeStats stats{};
+    stats.name = history.name;
+    stats.samples = history.total;
+    if (history.samples.empty()) {
+        return stats;
+    }
+
+    stats.lastMs = history.samples[(history.next + history.samples.size() - 1) % history.samples.size()];
+
+    std::vector<double> sorted = history.samples;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double sample : sorted) {
+        sum += sample;
+    }
+
+    stats.minMs = sorted.front();
+    stats.avgMs = sum / static_cast<double>(sorted.size());
+    stats.p99Ms = sorted[std::min(sorted.size() - 1, (sorted.size() * 99) / 100)];
+    return stats;
+}
+
+std::vector<ScopeStats> GpuProfiler::getStats() const {
+    std::vector<ScopeStats> stats;
+    stats.reserve(scopes.size());
+    for (const auto& history : scopes) {
+        stats.push_back(summarize(history));
+    }
+    return stats;
+}
+
+std::optional<ScopeStats> GpuProfiler::getStats(std::string_view name) const {
+    auto it = scopeLookup.find(std::string(name));
+    if (it == scopeLookup.end()) {
+        return std::nullopt;
+    }
+    return summarize(scopes[it->second]);
+}
+
+void GpuProfiler::logSummary() const {
+    if (!enabled) {
+        return;
+    }
+
+    for (const auto& stats : getStats()) {
+        spdlog::info("GPU {}: min {:.3f}ms avg {:.3f}ms p99 {:.3f}ms ({} samples)", stats.name, stats.minMs,
+                     stats.avgMs, stats.p99Ms, stats.samples);
+    }
+    if (statisticsEnabled) {
+        spdlog::info("GPU pipeline statistics: {} vertices, {} primitives, {} VS invocations, {} FS invocations",
+                     statistics.inputAssemblyVertices, statistics.inputAssemblyPrimitives,
+                     statistics.vertexShaderInvocations, statistics.fragmentShaderInvocations);
+    }
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -8,21 +8,28 @@ QueueFamilyIndices FindQueueFamilies(const vk::raii::PhysicalDevice& device, con
     auto queueFamilies = device.getQueueFamilyProperties();
     int i = 0;
     for (const auto& queueFamily : queueFamilies) {
-        if (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics) {
+        if (!indices.graphicsFamily && (queueFamily.queueFlags & vk::QueueFlagBits::eGraphics)) {
             indices.graphicsFamily = i;
         }
 
-        auto presentSupport = device.getSurfaceSupportKHR(i, surface);
-        if (presentSupport) {
+        if (surface && !indices.presentFamily && device.getSurfaceSupportKHR(i, surface)) {
             indices.presentFamily = i;
         }
 
-        if (indices.isComplete()) {
-            break;
+        // Prefer a pure copy queue (DMA engine), otherwise any family that can transfer but not draw.
+        bool transfer = (queueFamily.queueFlags & vk::QueueFlagBits::eTransfer) &&
+                        !(queueFamily.queueFlags & vk::QueueFlagBits::eGraphics);
+        if (transfer && (!indices.transferFamily || !(queueFamily.queueFlags & vk::QueueFlagBits::eCompute))) {
+            indices.transferFamily = i;
         }
 
         i++;
     }
+
+    if (!surface) {
+        // Headless: nothing is presented, the graphics queue stands in for the present queue.
+        indices.presentFamily = indices.graphicsFamily;
+    }
     return indices;
 }
 
@@ -0,0 +1,112 @@
+#include "Graphics/Vulkan/Recorder.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+
+namespace Solaris::Graphics::Vulkan {
+
+void ParallelRecorder::init(const vk::raii::Device& _device,
+                            uint32_t queueFamily,
+                            size_t framesInFlight,
+                            JobSystem& _jobs) {
+    device = &_device;
+    jobs = &_jobs;
+    sliceCount = jobs->size();
+
+    vk::CommandPoolCreateInfo ci{vk::CommandPoolCreateFlagBits::eTransient, queueFamily};
+    frames.resize(framesInFlight);
+    for (auto& slices : frames) {
+        slices.resize(sliceCount);
+        for (auto& slice : slices) {
+            slice.pool = {*device, ci};
+        }
+    }
+
+    spdlog::info("Parallel recorder using {} slices, {} command pools.", sliceCount, sliceCount * framesInFlight);
+}
+
+void ParallelRecorder::beginFrame(uint32_t frameIndex) {
+    for (auto& slice : frames[frameIndex]) {
+        if (slice.used > 0) {
+            slice.pool.reset();
+            slice.used = 0;
+        }
+    }
+}
+
+const vk::raii::CommandBuffer& ParallelRecorder::acquire(SlicePool& slice) {
+    if (slice.used == slice.buffers.size()) {
+        vk::CommandBufferAllocateInfo ai{};
+        ai.setCommandPool(*slice.pool);
+        ai.setLevel(vk::CommandBufferLevel::eSecondary);
+        ai.setCommandBufferCount(1);
+        slice.buffers.push_back(std::move(device->allocateCommandBuffers(ai).front()));
+    }
+    return slice.buffers[slice.used++];
+}
+
+void ParallelRecorder::record(const vk::raii::CommandBuffer& primary,
+                              uint32_t frameIndex,
+                              const vk::CommandBufferInheritanceInfo& inheritance,
+                              uint32_t itemCount,
+                              const SliceFn& recordSlice,
+                              uint32_t minItemsPerSlice) {
+    if (itemCount == 0) {
+        return;
+    }
+
+    auto& slices = frames[frameIndex];
+    uint32_t count = std::clamp<uint32_t>(itemCount / std::max(minItemsPerSlice, 1u), 1,
+                                          static_cast<uint32_t>(slices.size()));
+    uint32_t perSlice = (itemCount + count - 1) / count;
+
+    std::vector<vk::CommandBuffer> secondaries(count);
+    auto recordOne = [&](uint32_t i) {
+        const auto& cmd = acquire(slices[i]);
+
+        vk::CommandBufferBeginInfo bi{};
+        bi.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                    vk::CommandBufferUsageFlagBits::eRenderPassContinue);
+        bi.setPInheritanceInfo(&inheritance);
+        cmd.begin(bi);
+
+        uint32_t begin = i * perSlice;
+        uint32_t end = std::min(itemCount, begin + perSlice);
+        recordSlice(cmd, begin, end);
+
+        cmd.end();
+        secondaries[i] = *cmd;
+    };
+
+    // The first failing slice's exception is kept and rethrown once every job is done, they reference this
+    // stack frame.
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto recordGuarded = [&](uint32_t i) {
+        try {
+            recordOne(i);
+        } catch (...) {
+            std::lock_guard lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    JobCounter counter;
+    for (uint32_t i = 1; i < count; i++) {
+        jobs->run([&recordGuarded, i] { recordGuarded(i); }, counter);
+    }
+    recordGuarded(0);
+    jobs->wait(counter);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    primary.executeCommands(secondaries);
+}
+
+}  // namespace Solaris::Graphics::Vulkan
@@ -0,0 +1,76 @@
+#include "Graphics/Vulkan/RingBuffer.hpp"
+
+#include <spdlog/spdlog.h>
+#include <vulkan/vulkan_enums.hpp>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace Solaris::Graphics::Vulkan {
+
+void FrameRingBuffer::init(vma::Allocator* allocator,
+                           const vk::raii::PhysicalDevice& physicalDevice,
+                           size_t frameCount,
+                           vk::DeviceSize _frameSize) {
+    const auto& limits = physicalDevice.getProperties().limits;
+    uniformAlignment = std::max<vk::DeviceSize>(limits.minUniformBufferOffsetAlignment, 16);
+    storageAlignment = std::max<vk::DeviceSize>(limits.minStorageBufferOffsetAlignment, 16);
+
+    // Keep every frame region aligned for the strictest offset requirement.
+    vk::DeviceSize regionAlignment = std::max(uniformAlignment, storageAlignment);
+    frameSize = (_frameSize + regionAlignment - 1) / regionAlignment * regionAlignment;
+
+    buffer.init(allocator, frameSize * frameCount,
+                vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer |
+                    vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer |
+                    vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+                true, false, MemoryCategory::PerFrame);
+
+    mapped = static_cast<std::byte*>(buffer.getAllocationInfo().pMappedData);
+    if (mapped == nullptr) {
+        throw std::runtime_error("Frame ring buffer is not persistently mapped");
+    }
+
+    spdlog::info("Frame ring buffer: {} frames x {} KiB.", frameCount, frameSize / 1024);
+}
+
+void FrameRingBuffer::beginFrame(uint32_t frameIndex) {
+    highWater = std::max(highWater, head.load(std::memory_order_relaxed));
+    base = frameSize * frameIndex;
+    head.store(0, std::memory_order_relaxed);
+    recording.store(true, std::memory_order_release);
+}
+
+void FrameRingBuffer::flush() {
+    recording.store(false, std::memory_order_release);
+    auto used = head.load(std::memory_order_acquire);
+    if (used > 0) {
+        buffer.flush(base, used);
+    }
+}
+
+TransientAllocation FrameRingBuffer::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    if (!recording.load(std::memory_order_acquire)) {
+        throw std::runtime_error("Frame ring buffer used outside of frame recording, e.g. from onSimulate");
+    }
+    alignment = std::max<vk::DeviceSize>(alignment, 4);
+    vk::DeviceSize offset = head.load(std::memory_order_relaxed);
+    vk::DeviceSize aligned = 0;
+    do {
+        aligned = (offset + alignment - 1) / alignment * alignment;
+        if (aligned + size > frameSize) {
+            throw std::runtime_error(
+                std::format("Frame ring buffer exhausted: {} of {} bytes used, {} requested", offset, frameSize, size));
+        }
+    } while (!head.compare_exchange_weak(offset, aligned + size, std::memory_order_acq_rel));
+
+    TransientAllocation alloc{};
+    alloc.data = mapped + base + aligned;
+    alloc.buffer = buffer.getBuffer();
+    alloc.offset = base + aligned;
+    alloc.size = size;
+    return alloc;
+}
+
+}  // namespace Solaris::Graphics::Vulkan
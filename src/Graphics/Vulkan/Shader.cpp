@@ -1,9 +1,30 @@
 #include "Graphics/Vulkan/Shader.hpp"
+#include "Core/Hash.hpp"
+#include "Core/MappedFile.hpp"
 
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <utility>
+
+#if defined(__linux__) && !defined(NDEBUG)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define SOLARIS_SHADER_HOT_RELOAD 1
+#endif
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
 
 namespace Solaris::Graphics::Vulkan {
 
+constexpr uint32_t spirvMagic = 0x07230203;
+
 std::vector<char> readFile(const std::string& fileName) {
     std::ifstream file(fileName, std::ios::ate | std::ios::binary);
 
@@ -20,7 +41,176 @@ std::vector<char> readFile(const std::string& fileName) {
 }
 
 vk::raii::ShaderModule createShaderModule(const vk::raii::Device& device, const std::vector<char>& code) {
-    vk::ShaderModuleCreateInfo createInfo({}, code.size(), reinterpret_cast<const uint32_t*>(code.data()));
+    // A char buffer carries no alignment guarantee for uint32_t words, copy into one that does.
+    std::vector<uint32_t> words((code.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    std::memcpy(words.data(), code.data(), code.size());
+    return createShaderModule(device, words);
+}
+
+vk::raii::ShaderModule createShaderModule(const vk::raii::Device& device, std::span<const uint32_t> code) {
+    vk::ShaderModuleCreateInfo createInfo({}, code.size_bytes(), code.data());
     return vk::raii::ShaderModule(device, createInfo);
 }
-}  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
+
+uint64_t hashShaderCode(const std::vector<char>& code) {
+    return Fnv1a(code.data(), code.size());
+}
+
+std::filesystem::path GetShaderDirectory() {
+    std::error_code error;
+#if defined(SOLARIS_SHADER_DIR) && !defined(NDEBUG)
+    if (std::filesystem::is_directory(SOLARIS_SHADER_DIR, error)) {
+        return SOLARIS_SHADER_DIR;
+    }
+#endif
+
+    std::filesystem::path executable;
+#if defined(_WIN32)
+    std::wstring buffer(MAX_PATH, L'\0');
+    auto length = GetModuleFileNameW(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()));
+    buffer.resize(length);
+    executable = buffer;
+#elif defined(__linux__)
+    executable = std::filesystem::read_symlink("/proc/self/exe", error);
+#endif
+    if (!executable.empty()) {
+        auto directory = executable.parent_path() / "shaders";
+        if (std::filesystem::is_directory(directory, error)) {
+            return directory;
+        }
+    }
+    return "shaders";
+}
+
+ShaderRegistry::~ShaderRegistry() {
+    if (watcher.joinable()) {
+        watcher.request_stop();
+        watcher.join();
+    }
+}
+
+void ShaderRegistry::init(const vk::raii::Device& _device, std::filesystem::path _directory) {
+    device = &_device;
+    directory = std::move(_directory);
+
+#if defined(SOLARIS_SHADER_HOT_RELOAD)
+    watcher = std::jthread([this](std::stop_token stop) { watch(stop); });
+    spdlog::info("Watching {} for shader changes.", directory.string());
+#endif
+}
+
+uint64_t ShaderRegistry::loadFile(const std::string& file) {
+    // mmap returns page aligned memory, so the words can be handed to the driver without a copy.
+    MappedFile mapped(directory / file);
+    if (mapped.size() < sizeof(uint32_t) || mapped.size() % sizeof(uint32_t) != 0 ||
+        *reinterpret_cast<const uint32_t*>(mapped.data()) != spirvMagic) {
+        throw std::runtime_error(std::format("{} is not a SPIR-V binary", file));
+    }
+
+    uint64_t hash = Fnv1a(mapped.bytes());
+    if (!modules.contains(hash)) {
+        std::span<const uint32_t> words(reinterpret_cast<const uint32_t*>(mapped.data()),
+                                        mapped.size() / sizeof(uint32_t));
+        modules.emplace(hash, createShaderModule(*device, words));
+    }
+    files[file] = hash;
+    return hash;
+}
+
+ShaderStageDesc ShaderRegistry::load(const std::string& file,
+                                     vk::ShaderStageFlagBits stage,
+                                     const std::string& entryPoint) {
+    std::lock_guard lock(mutex);
+
+    auto it = files.find(file);
+    uint64_t hash = it != files.end() ? it->second : loadFile(file);
+
+    ShaderStageDesc desc{};
+    desc.stage = stage;
+    desc.module = *modules.at(hash);
+    desc.entryPoint = entryPoint;
+    desc.codeHash = hash;
+    desc.path = file;
+    return desc;
+}
+
+std::vector<std::string> ShaderRegistry::pollChanges() {
+    std::set<std::string> pending;
+    {
+        std::lock_guard lock(changedMutex);
+        pending.swap(changed);
+    }
+
+    std::vector<std::string> reloaded;
+    std::lock_guard lock(mutex);
+    for (const auto& file : pending) {
+        auto it = files.find(file);
+        if (it == files.end()) {
+            continue;  // never loaded, nothing depends on it
+        }
+
+        uint64_t previous = it->second;
+        try {
+            if (loadFile(file) != previous) {
+                spdlog::info("Shader {} changed, rebuilding dependent pipelines.", file);
+                reloaded.push_back(file);
+
+                // Pipelines still compiling from the old code may use the module, the pipeline registry keeps it
+                // alive until they are done.
+                bool shared = std::ranges::any_of(files, [&](const auto& other) { return other.second == previous; });
+                if (!shared) {
+                    auto module = modules.extract(previous);
+                    retired.push_back(std::move(module.mapped()));
+                }
+            }
+        } catch (std::runtime_error& err) {
+            // Keep running with the old code, e.g. when the compiler is still writing the file.
+            spdlog::warn("Failed to reload shader {}: {}", file, err.what());
+        }
+    }
+    return reloaded;
+}
+
+std::vector<vk::raii::ShaderModule> ShaderRegistry::takeRetired() {
+    std::lock_guard lock(mutex);
+    return std::exchange(retired, {});
+}
+
+void ShaderRegistry::watch(std::stop_token stop) {
+#if defined(SOLARIS_SHADER_HOT_RELOAD)
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        spdlog::warn("inotify unavailable, shader hot reload disabled.");
+        return;
+    }
+    if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        spdlog::warn("Failed to watch {}, shader hot reload disabled.", directory.string());
+        ::close(fd);
+        return;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+    while (!stop.stop_requested()) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+
+        ssize_t length = ::read(fd, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < length;) {
+            auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0) {
+                std::string name = event->name;
+                if (name.ends_with(".spv")) {
+                    std::lock_guard lock(changedMutex);
+                    changed.insert(name);
+                }
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    ::close(fd);
+#endif
+}
+
+}  // namespace Solaris::Graphics::Vulkan
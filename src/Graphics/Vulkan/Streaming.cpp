@@ -0,0 +1,410 @@
+#include "Graphics/Vulkan/Streaming.hpp"
+#include "Graphics/Vulkan/Upload.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#define SOLARIS_HAS_PREAD 1
+#endif
+
+namespace Solaris::Graphics::Vulkan {
+
+namespace {
+
+// Frames an eviction is assumed to take until its memory is released and shows in the heap budgets.
+constexpr uint64_t kEvictionSettleFrames = 4;
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+// Positional reads from one file, owned by the I/O thread.
+class InputFile {
+   public:
+    InputFile() = default;
+    ~InputFile() { close(); }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    bool open(const std::filesystem::path& path) {
+#if defined(SOLARIS_HAS_PREAD)
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        if (fd < 0 || ::fstat(fd, &st) != 0) {
+            return false;
+        }
+        fileSize = static_cast<vk::DeviceSize>(st.st_size);
+        return true;
+#else
+        file.open(path, std::ios::ate | std::ios::binary);
+        fileSize = file.is_open() ? static_cast<vk::DeviceSize>(file.tellg()) : 0;
+        return file.is_open();
+#endif
+    }
+
+    [[nodiscard]] vk::DeviceSize size() const { return fileSize; }
+
+    bool readAt(vk::DeviceSize offset, std::byte* dst, vk::DeviceSize size) {
+#if defined(SOLARIS_HAS_PREAD)
+        while (size > 0) {
+            ssize_t n = ::pread(fd, dst, size, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            dst += n;
+            offset += static_cast<vk::DeviceSize>(n);
+            size -= static_cast<vk::DeviceSize>(n);
+        }
+        return true;
+#else
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(size));
+        return file.good();
+#endif
+    }
+
+   private:
+    void close() {
+#if defined(SOLARIS_HAS_PREAD)
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+    }
+
+#if defined(SOLARIS_HAS_PREAD)
+    int fd = -1;
+#else
+    std::ifstream file;
+#endif
+    vk::DeviceSize fileSize = 0;
+};
+
+}  // namespace
+
+AssetStreamer::~AssetStreamer() {
+    shutdown();
+}
+
+void AssetStreamer::init(vma::Allocator* allocator,
+                         const vk::PhysicalDeviceMemoryProperties& memoryProperties,
+                         UploadManager& _uploads,
+                         const Config& _config) {
+    uploads = &_uploads;
+    config = _config;
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        memoryTypeHeaps.push_back(memoryProperties.memoryTypes[i].heapIndex);
+    }
+
+    slots.resize(config.stagingSlots);
+    for (uint32_t i = 0; i < config.stagingSlots; i++) {
+        slots[i].init(allocator, config.slotSize, vk::BufferUsageFlagBits::eTransferSrc, true, false,
+                      MemoryCategory::Staging);
+        auto* mapped = static_cast<std::byte*>(slots[i].getAllocationInfo().pMappedData);
+        if (mapped == nullptr) {
+            throw std::runtime_error("Streaming staging memory is not persistently mapped");
+        }
+        slotData.push_back(mapped);
+        freeSlots.push_back(i);
+    }
+
+    io = std::jthread([this](std::stop_token stop) { ioLoop(stop); });
+    spdlog::info("Asset streamer: {} staging slots of {} KiB, {} KiB per frame.", config.stagingSlots,
+                 config.slotSize / 1024, config.bytesPerFrame / 1024);
+}
+
+void AssetStreamer::shutdown() {
+    if (io.joinable()) {
+        io.request_stop();
+        io.join();
+    }
+    // Pending callbacks are dropped without running.
+    requests.clear();
+    queue.clear();
+    filled.clear();
+    resident.clear();
+}
+
+StreamHandle AssetStreamer::request(StreamRequest request) {
+    if (request.dst == nullptr) {
+        throw std::runtime_error(std::format("Stream request for {} has no destination buffer",
+                                             request.path.string()));
+    }
+
+    uint64_t id;
+    {
+        std::lock_guard lock(mutex);
+        id = nextId++;
+        requests.emplace(id, Request{std::move(request)});
+        queue.push_back(id);
+    }
+    wake.notify_one();
+    return {id};
+}
+
+bool AssetStreamer::cancel(StreamHandle handle) {
+    std::lock_guard lock(mutex);
+    auto it = requests.find(handle.id);
+    if (it == requests.end()) {
+        return false;
+    }
+
+    auto& entry = it->second;
+    if (entry.cancelled || entry.failed || (entry.allRead && entry.chunksFilled == 0)) {
+        return false;
+    }
+    // Filled chunks go back to the free slots in update(), a chunk being read when the I/O thread is done.
+    entry.cancelled = true;
+    std::erase(queue, handle.id);
+    return true;
+}
+
+size_t AssetStreamer::pending() const {
+    std::lock_guard lock(mutex);
+    return requests.size();
+}
+
+vk::DeviceSize AssetStreamer::getResidentBytes() const {
+    vk::DeviceSize total = 0;
+    for (const auto& entry : resident) {
+        total += entry.size;
+    }
+    return total;
+}
+
+void AssetStreamer::release(StreamHandle handle) {
+    std::erase_if(resident, [&](const Resident& entry) { return entry.id == handle.id; });
+}
+
+vk::DeviceSize AssetStreamer::evict(uint32_t heap, vk::DeviceSize bytes) {
+    for (const auto& recent : recentEvictions) {
+        if (recent.heap == heap) {
+            bytes -= std::min(bytes, recent.size);
+        }
+    }
+
+    // `resident` is in completion order, so a stable sort keeps the oldest first among equal priorities.
+    std::vector<size_t> order;
+    for (size_t i = 0; i < resident.size(); i++) {
+        if (resident[i].heap == heap) {
+            order.push_back(i);
+        }
+    }
+    std::ranges::stable_sort(order, {}, [&](size_t i) { return resident[i].priority; });
+
+    vk::DeviceSize evicted = 0;
+    std::vector<bool> dropped(resident.size());
+    for (size_t i : order) {
+        if (evicted >= bytes) {
+            break;
+        }
+        evicted += resident[i].size;
+        dropped[i] = true;
+    }
+    if (evicted == 0) {
+        return 0;
+    }
+
+    std::vector<std::move_only_function<void()>> callbacks;
+    size_t kept = 0;
+    for (size_t i = 0; i < resident.size(); i++) {
+        if (dropped[i]) {
+            callbacks.push_back(std::move(resident[i].onEvict));
+        } else {
+            resident[kept++] = std::move(resident[i]);
+        }
+    }
+    resident.erase(resident.begin() + static_cast<std::ptrdiff_t>(kept), resident.end());
+    recentEvictions.push_back({frame, heap, evicted});
+    spdlog::info("Evicted {} streamed assets ({:.1f} MiB) from memory heap {} under budget pressure.",
+                 callbacks.size(), static_cast<double>(evicted) / kMiB, heap);
+
+    // After the bookkeeping, a callback may release or request more.
+    for (auto& callback : callbacks) {
+        callback();
+    }
+    return evicted;
+}
+
+bool AssetStreamer::isFinished(const Request& request) const {
+    if (request.reading || request.chunksFilled > 0) {
+        return false;
+    }
+    if (!request.allRead && !request.failed && !request.cancelled) {
+        return false;
+    }
+    // Copies already submitted still read from staging and write into the destination.
+    return request.ticket == 0 || uploads->isComplete(request.ticket);
+}
+
+void AssetStreamer::update() {
+    frame++;
+    while (!recentEvictions.empty() && recentEvictions.front().frame + kEvictionSettleFrames <= frame) {
+        recentEvictions.pop_front();
+    }
+
+    std::vector<std::pair<std::move_only_function<void(StreamStatus)>, StreamStatus>> finished;
+    bool freed = false;
+    {
+        std::lock_guard lock(mutex);
+
+        while (!inFlight.empty() && uploads->isComplete(inFlight.front().ticket)) {
+            freeSlots.push_back(inFlight.front().slot);
+            inFlight.pop_front();
+            freed = true;
+        }
+
+        vk::DeviceSize spent = 0;
+        std::vector<uint32_t> copiedSlots;
+        std::vector<uint64_t> copiedRequests;
+        while (!filled.empty() && (copiedSlots.empty() || spent + filled.front().size <= config.bytesPerFrame)) {
+            auto chunk = filled.front();
+            filled.pop_front();
+
+            auto& entry = requests.at(chunk.request);
+            entry.chunksFilled--;
+            if (entry.cancelled || entry.failed) {
+                freeSlots.push_back(chunk.slot);
+                freed = true;
+                continue;
+            }
+
+            slots[chunk.slot].flush(0, chunk.size);
+            uploads->copy(slots[chunk.slot], 0, *entry.desc.dst, entry.desc.dstOffset + chunk.offset, chunk.size);
+            spent += chunk.size;
+            copiedSlots.push_back(chunk.slot);
+            copiedRequests.push_back(chunk.request);
+        }
+
+        if (!copiedSlots.empty()) {
+            uint64_t ticket = uploads->flush();
+            for (auto slot : copiedSlots) {
+                inFlight.push_back({slot, ticket});
+            }
+            for (auto id : copiedRequests) {
+                requests.at(id).ticket = ticket;
+            }
+        }
+
+        for (auto it = requests.begin(); it != requests.end();) {
+            auto& entry = it->second;
+            if (!isFinished(entry)) {
+                ++it;
+                continue;
+            }
+            auto status = entry.cancelled ? StreamStatus::Cancelled
+                          : entry.failed  ? StreamStatus::Failed
+                                          : StreamStatus::Ready;
+            if (entry.desc.onComplete) {
+                finished.emplace_back(std::move(entry.desc.onComplete), status);
+            }
+            if (status == StreamStatus::Ready && entry.desc.onEvict) {
+                uint32_t type = entry.desc.dst->getAllocationInfo().memoryType;
+                resident.push_back({it->first, entry.desc.priority, memoryTypeHeaps.at(type), entry.total,
+                                    std::move(entry.desc.onEvict)});
+            }
+            it = requests.erase(it);
+        }
+    }
+
+    if (freed) {
+        wake.notify_one();
+    }
+    // Outside the lock, a callback may queue more requests.
+    for (auto& [callback, status] : finished) {
+        callback(status);
+    }
+}
+
+void AssetStreamer::ioLoop(std::stop_token stop) {
+    std::unordered_map<uint64_t, InputFile> files;
+
+    std::unique_lock lock(mutex);
+    while (true) {
+        // Requests that left the queue are done reading, fully or because they failed or were cancelled.
+        std::erase_if(files, [this](const auto& file) { return std::ranges::find(queue, file.first) == queue.end(); });
+
+        if (!wake.wait(lock, stop, [this] { return !queue.empty() && !freeSlots.empty(); })) {
+            return;
+        }
+
+        uint64_t id = *std::ranges::max_element(queue, [this](uint64_t a, uint64_t b) {
+            int32_t pa = requests.at(a).desc.priority;
+            int32_t pb = requests.at(b).desc.priority;
+            return pa < pb || (pa == pb && a > b);
+        });
+        auto& entry = requests.at(id);
+        entry.reading = true;
+
+        auto fail = [&](std::string_view reason) {
+            spdlog::error("Streaming {} failed: {}.", entry.desc.path.string(), reason);
+            entry.failed = true;
+            std::erase(queue, id);
+        };
+
+        if (!entry.opened) {
+            // The description does not change after request(), and the entry stays while it is being read.
+            lock.unlock();
+            auto& file = files[id];
+            bool opened = file.open(entry.desc.path);
+            lock.lock();
+
+            entry.opened = true;
+            entry.reading = false;
+            if (!opened) {
+                fail("cannot open the file");
+            } else if (entry.desc.fileOffset > file.size() ||
+                       entry.desc.size > file.size() - entry.desc.fileOffset) {
+                fail("range past the end of the file");
+            } else {
+                entry.total = entry.desc.size > 0 ? entry.desc.size : file.size() - entry.desc.fileOffset;
+                if (entry.total == 0) {
+                    entry.allRead = true;
+                    std::erase(queue, id);
+                }
+            }
+            continue;
+        }
+
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        vk::DeviceSize offset = entry.read;
+        vk::DeviceSize size = std::min(config.slotSize, entry.total - entry.read);
+        entry.read += size;
+
+        lock.unlock();
+        bool ok = files[id].readAt(entry.desc.fileOffset + offset, slotData[slot], size);
+        lock.lock();
+
+        entry.reading = false;
+        if (!ok) {
+            freeSlots.push_back(slot);
+            fail("read error");
+        } else if (entry.cancelled) {
+            freeSlots.push_back(slot);
+        } else {
+            filled.push_back({id, slot, offset, size});
+            entry.chunksFilled++;
+            if (entry.read == entry.total) {
+                entry.allRead = true;
+                std::erase(queue, id);
+            }
+        }
+    }
+}
+
+}  // namespace Solaris::Graphics::Vulkan
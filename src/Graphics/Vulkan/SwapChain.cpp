@@ -2,13 +2,32 @@
 #include "Graphics/Vulkan/Context.hpp"
 #include "Graphics/Vulkan/QueueFamily.hpp"
 
+#include <spdlog/spdlog.h>
+
+#include <vulkan/vulkan_to_string.hpp>
+
 #include <vulkan/vulkan_core.h>
 #include <vulkan/vulkan_enums.hpp>
 #include <vulkan/vulkan_handles.hpp>
 #include <vulkan/vulkan_raii.hpp>
 
+#include <algorithm>
+#include <iterator>
+
 namespace Solaris::Graphics::Vulkan {
 
+namespace {
+
+// Everything that goes away with a swapchain on resize and is only used by frames in flight. The present
+// semaphores are not part of it, see Context::retiredPresentSemaphores.
+struct RetiredSwapchain {
+    vk::raii::SwapchainKHR swapchain{nullptr};
+    std::vector<vk::raii::ImageView> views;
+    std::vector<vk::raii::Framebuffer> framebuffers;
+};
+
+}  // namespace
+
 vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
     for (const auto& availableFormat : availableFormats) {
         if (availableFormat.format == vk::Format::eB8G8R8A8Srgb &&
@@ -19,13 +38,15 @@ vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormat
     return availableFormats[0];
 }
 
-vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
+vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes,
+                                         vk::PresentModeKHR requested) {
     for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
+        if (availablePresentMode == requested) {
             return availablePresentMode;
         }
     }
 
+    spdlog::info("Present mode {} is not supported, falling back to FIFO.", vk::to_string(requested));
     return vk::PresentModeKHR::eFifo;
 }
 
@@ -60,7 +81,16 @@ void Context::initSwapchain(GLFWwindow* window, const vk::raii::SwapchainKHR& ol
     auto swapChainSupport = QuerySwapChainSupport(surface, physicalDevice);
 
     auto format = chooseSwapSurfaceFormat(swapChainSupport.formats);
-    auto presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+    if (*renderPass != VK_NULL_HANDLE) {
+        // The render pass and every pipeline built against it assume the current format, keep it.
+        auto current = std::ranges::find(swapChainSupport.formats, swapchainFormat, &vk::SurfaceFormatKHR::format);
+        if (current == swapChainSupport.formats.end()) {
+            throw std::runtime_error(std::format("Surface no longer supports the render pass format {}",
+                                                 vk::to_string(swapchainFormat)));
+        }
+        format = *current;
+    }
+    presentMode = chooseSwapPresentMode(swapChainSupport.presentModes, requestedPresentMode);
     auto extent = chooseSwapExtent(swapChainSupport.capabilities, window);
 
     uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
@@ -99,7 +129,56 @@ void Context::initSwapchain(GLFWwindow* window, const vk::raii::SwapchainKHR& ol
     swapchainFormat = format.format;
     swapchainExtent = extent;
 
-    // Render Pass
+    if (*renderPass == VK_NULL_HANDLE) {
+        initRenderPass(vk::ImageLayout::ePresentSrcKHR);
+    }
+}
+
+void Context::initOffscreen(vk::Extent2D extent, uint32_t imageCount) {
+    swapchainFormat = vk::Format::eR8G8B8A8Unorm;
+    swapchainExtent = extent;
+
+    offscreenImages.clear();
+    offscreenImages.resize(imageCount);
+    swapchainImages.clear();
+    swapchainImages.reserve(imageCount);
+
+    for (auto& image : offscreenImages) {
+        image.init(&*allocator, extent, swapchainFormat,
+                   vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+                   MemoryCategory::RenderTargets);
+        swapchainImages.push_back(image.getImage());
+    }
+    offscreenImageIndex = 0;
+
+    spdlog::info("Created {} offscreen images ({}x{}).", imageCount, extent.width, extent.height);
+
+    // Leave the images ready to be copied out for readback.
+    initRenderPass(vk::ImageLayout::eTransferSrcOptimal);
+}
+
+void Context::waitForLastPresent() {
+    if (headless || !features.presentWait) {
+        frames.wait(device, frames.getSubmittedValue());
+        return;
+    }
+    if (presentId == 0) {
+        return;
+    }
+    // Bounded, a present to a swapchain that has gone out of date may never complete.
+    try {
+        (void)swapchain.waitForPresent(presentId, 100'000'000);
+    } catch (vk::OutOfDateKHRError&) {
+    }
+}
+
+uint32_t Context::acquireOffscreenImage() {
+    uint32_t imageIndex = offscreenImageIndex;
+    offscreenImageIndex = (offscreenImageIndex + 1) % static_cast<uint32_t>(swapchainImages.size());
+    return imageIndex;
+}
+
+void Context::initRenderPass(vk::ImageLayout finalLayout) {
     vk::AttachmentDescription colorAttachment{};
     colorAttachment.format = swapchainFormat;
     colorAttachment.samples = vk::SampleCountFlagBits::e1;
@@ -108,7 +187,7 @@ void Context::initSwapchain(GLFWwindow* window, const vk::raii::SwapchainKHR& ol
     colorAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
     colorAttachment.stencilStoreOp = vk::AttachmentStoreOp::eStore;
     colorAttachment.initialLayout = vk::ImageLayout::eUndefined;
-    colorAttachment.finalLayout = vk::ImageLayout::ePresentSrcKHR;
+    colorAttachment.finalLayout = finalLayout;
 
     vk::AttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
@@ -171,19 +250,40 @@ void Context::initSwapchainResources() {
 
         swapchainFramebuffers.emplace_back(device, frambufferInfo);
     }
+
+    // Present Semaphores
+    presentSemaphores.clear();
+    if (!headless) {
+        presentSemaphores.reserve(swapchainImages.size());
+        for (size_t i = 0; i < swapchainImages.size(); i++) {
+            presentSemaphores.emplace_back(device, vk::SemaphoreCreateInfo{});
+        }
+    }
 }
 
 void Context::recreateSwapchain(GLFWwindow* window) {
-    device.waitIdle();
-    vk::raii::SwapchainKHR oldSwap = std::move(swapchain);
-    destroySwapchainResources();
-    initSwapchain(window, oldSwap);
+    RetiredSwapchain retired{};
+    retired.swapchain = std::move(swapchain);
+    retired.views = std::move(swapchainViews);
+    retired.framebuffers = std::move(swapchainFramebuffers);
+    // The last present of each image may still be waiting on its semaphore.
+    std::ranges::move(presentSemaphores, std::back_inserter(retiredPresentSemaphores));
+    presentSemaphores.clear();
+
+    // Present ids count per swapchain.
+    presentId = 0;
+    initSwapchain(window, retired.swapchain);
     initSwapchainResources();
+    deletionQueue.retire(std::move(retired));
+
+    spdlog::debug("Recreated swapchain at {}x{}.", swapchainExtent.width, swapchainExtent.height);
 }
 
-void Context::destroySwapchainResources() {
-    swapchainFramebuffers.clear();
-    swapchainViews.clear();
+void Context::onImageAcquired() {
+    if (!retiredPresentSemaphores.empty()) {
+        deletionQueue.retire(std::move(retiredPresentSemaphores));
+        retiredPresentSemaphores.clear();
+    }
 }
 
 }  // namespace Solaris::Graphics::Vulkan
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "Graphics/Vulkan/Upload.hpp"
+
+#include <spdlog/spdlog.h>
+#include <vulkan/vulkan_enums.hpp>
+#include <vulkan/vulkan_raii.hpp>
+#include <vulkan/vulkan_structs.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace Solaris::Graphics::Vulkan {
+
+// Everything an uploaded buffer can be consumed as on the graphics queue.
+constexpr vk::PipelineStageFlags consumerStages =
+    vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput |
+    vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader |
+    vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer;
+constexpr vk::AccessFlags consumerAccess =
+    vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eIndexRead |
+    vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead |
+    vk::AccessFlagBits::eTransferRead;
+
+void UploadManager::init(const vk::raii::Device& _device,
+                         vma::Allocator* _allocator,
+                         const QueueFamilyIndices& families,
+                         vk::Queue _graphicsQueue,
+                         vk::Queue _transferQueue) {
+    device = &_device;
+    allocator = _allocator;
+    graphicsQueue = _graphicsQueue;
+    transferQueue = _transferQueue;
+    graphicsFamily = families.graphicsFamily.value();
+    dedicated = families.hasDedicatedTransfer();
+    transferFamily = dedicated ? families.transferFamily.value() : graphicsFamily;
+
+    vk::CommandPoolCreateInfo tp{vk::CommandPoolCreateFlagBits::eResetCommandBuffer, transferFamily};
+    transferPool = {*device, tp};
+    if (dedicated) {
+        vk::CommandPoolCreateInfo gp{vk::CommandPoolCreateFlagBits::eResetCommandBuffer, graphicsFamily};
+        graphicsPool = {*device, gp};
+    }
+
+    vk::SemaphoreTypeCreateInfo ti{vk::SemaphoreType::eTimeline, 0};
+    vk::SemaphoreCreateInfo si{};
+    si.setPNext(&ti);
+    timeline = {*device, si};
+    if (dedicated) {
+        copyTimeline = {*device, si};
+    }
+
+    spdlog::info("Upload manager using {} queue family {}.", dedicated ? "dedicated transfer" : "graphics",
+                 transferFamily);
+}
+
+UploadManager::Batch& UploadManager::openBatch() {
+    if (current) {
+        return *current;
+    }
+
+    if (!freeBatches.empty()) {
+        current = std::move(freeBatches.back());
+        freeBatches.pop_back();
+    } else {
+        current.emplace();
+
+        vk::CommandBufferAllocateInfo ai{};
+        ai.setCommandPool(transferPool);
+        ai.setLevel(vk::CommandBufferLevel::ePrimary);
+        ai.setCommandBufferCount(1);
+        current->transferCmd = std::move(device->allocateCommandBuffers(ai)[0]);
+
+        if (dedicated) {
+            ai.setCommandPool(graphicsPool);
+            current->acquireCmd = std::move(device->allocateCommandBuffers(ai)[0]);
+        }
+    }
+
+    current->transferCmd.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    return *current;
+}
+
+UploadManager::StagingChunk& UploadManager::stagingFor(Batch& batch, vk::DeviceSize size) {
+    // Copy offsets only need 4 byte alignment, keep every region on a 16 byte boundary anyway.
+    for (auto& chunk : batch.chunks) {
+        vk::DeviceSize offset = (chunk.used + 15) & ~vk::DeviceSize{15};
+        if (offset + size <= chunk.size) {
+            chunk.used = offset;
+            return chunk;
+        }
+    }
+
+    if (size <= kStagingChunkSize && !freeChunks.empty()) {
+        batch.chunks.push_back(std::move(freeChunks.back()));
+        freeChunks.pop_back();
+        return batch.chunks.back();
+    }
+
+    StagingChunk chunk{};
+    chunk.size = std::max(size, kStagingChunkSize);
+    chunk.buffer.init(allocator, chunk.size, vk::BufferUsageFlagBits::eTransferSrc, true, false,
+                      MemoryCategory::Staging);
+    batch.chunks.push_back(std::move(chunk));
+    return batch.chunks.back();
+}
+
+void UploadManager::upload(Buffer& dst, const void* data, vk::DeviceSize size, vk::DeviceSize dstOffset) {
+    if (size == 0) {
+        return;
+    }
+
+    auto& batch = openBatch();
+    auto& chunk = stagingFor(batch, size);
+
+    auto* mapped = static_cast<std::byte*>(chunk.buffer.getAllocationInfo().pMappedData);
+    if (mapped == nullptr) {
+        throw std::runtime_error("Staging memory is not persistently mapped");
+    }
+    std::memcpy(mapped + chunk.used, data, size);
+
+    recordCopy(batch, chunk.buffer.getBuffer(), chunk.used, dst, dstOffset, size);
+    chunk.used += size;
+}
+
+void UploadManager::copy(const Buffer& src,
+                         vk::DeviceSize srcOffset,
+                         Buffer& dst,
+                         vk::DeviceSize dstOffset,
+                         vk::DeviceSize size) {
+    if (size == 0) {
+        return;
+    }
+    recordCopy(openBatch(), src.getBuffer(), srcOffset, dst, dstOffset, size);
+}
+
+void UploadManager::recordCopy(Batch& batch,
+                               vk::Buffer src,
+                               vk::DeviceSize srcOffset,
+                               const Buffer& dst,
+                               vk::DeviceSize dstOffset,
+                               vk::DeviceSize size) {
+    vk::BufferCopy region{srcOffset, dstOffset, size};
+    batch.transferCmd.copyBuffer(src, dst.getBuffer(), region);
+
+    if (dedicated) {
+        batch.ownership.emplace_back(vk::AccessFlagBits::eTransferWrite, vk::AccessFlags{}, transferFamily,
+                                     graphicsFamily, dst.getBuffer(), dstOffset, size);
+    }
+}
+
+uint64_t UploadManager::flush() {
+    if (!current) {
+        return submitted;
+    }
+
+    auto batch = std::move(*current);
+    current.reset();
+
+    for (auto& chunk : batch.chunks) {
+        chunk.buffer.flush(0, chunk.used);
+    }
+
+    if (dedicated) {
+        // Release on the transfer queue, acquire on the graphics queue once the copies have landed.
+        batch.transferCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                          vk::PipelineStageFlagBits::eBottomOfPipe, {}, {}, batch.ownership, {});
+    }
+    batch.transferCmd.end();
+
+    // Without a dedicated family the copies run on the graphics queue and signal the ticket themselves.
+    const auto& copySemaphore = dedicated ? copyTimeline : timeline;
+    uint64_t copied = dedicated ? ++copyValue : ++timelineValue;
+    vk::TimelineSemaphoreSubmitInfo tsi{};
+    tsi.setSignalSemaphoreValues(copied);
+
+    vk::SubmitInfo si{};
+    si.setPNext(&tsi);
+    si.setCommandBuffers(*batch.transferCmd);
+    si.setSignalSemaphores(*copySemaphore);
+    transferQueue.submit(si);
+
+    if (dedicated) {
+        for (auto& barrier : batch.ownership) {
+            barrier.setSrcAccessMask({});
+            barrier.setDstAccessMask(consumerAccess);
+        }
+
+        batch.acquireCmd.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+        batch.acquireCmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, consumerStages, {}, {},
+                                         batch.ownership, {});
+        batch.acquireCmd.end();
+
+        uint64_t acquired = ++timelineValue;
+        vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTransfer;
+
+        vk::TimelineSemaphoreSubmitInfo ati{};
+        ati.setWaitSemaphoreValues(copied);
+        ati.setSignalSemaphoreValues(acquired);
+
+        vk::SubmitInfo asi{};
+        asi.setPNext(&ati);
+        asi.setWaitSemaphores(*copyTimeline);
+        asi.setWaitDstStageMask(waitStage);
+        asi.setCommandBuffers(*batch.acquireCmd);
+        asi.setSignalSemaphores(*timeline);
+        graphicsQueue.submit(asi);
+    }
+
+    batch.ticket = timelineValue;
+    submitted = batch.ticket;
+    inFlight.push_back(std::move(batch));
+    return submitted;
+}
+
+void UploadManager::collect() {
+    uint64_t completed = timeline.getCounterValue();
+
+    while (!inFlight.empty() && inFlight.front().ticket <= completed) {
+        auto batch = std::move(inFlight.front());
+        inFlight.pop_front();
+
+        for (auto& chunk : batch.chunks) {
+            if (chunk.size == kStagingChunkSize) {
+                chunk.used = 0;
+                freeChunks.push_back(std::move(chunk));
+            }
+        }
+        batch.chunks.clear();
+        batch.ownership.clear();
+
+        batch.transferCmd.reset();
+        if (dedicated) {
+            batch.acquireCmd.reset();
+        }
+        freeBatches.push_back(std::move(batch));
+    }
+}
+
+bool UploadManager::isComplete(uint64_t ticket) const {
+    return timeline.getCounterValue() >= ticket;
+}
+
+void UploadManager::wait(uint64_t ticket) const {
+    vk::SemaphoreWaitInfo wi{};
+    wi.setSemaphores(*timeline);
+    wi.setValues(ticket);
+    if (auto result = device->waitSemaphores(wi, UINT64_MAX); result != vk::Result::eSuccess) {
+        throw std::runtime_error(std::format("Failed to wait for uploads: {}", vk::to_string(result)));
+    }
+}
+
+}  // namespace Solaris::Graphics::Vulkan
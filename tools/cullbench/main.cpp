@@ -0,0 +1,147 @@
+// Measures Solaris::Graphics::FrustumCuller on random scenes.
+//
+//     cullbench [objects]
+//
+// Scatters `objects` (default 1M) bounding volumes around a camera looking down -z and culls them with every
+// path the CPU supports, on one thread and then across the job system. Every path must produce the same visible
+// list as the scalar one; the tool fails otherwise. The paths compute the plane distances in the same order without
+// fused multiply-adds, so objects that touch a plane are no exception.
+//
+// Known gap: the target is 1M objects in 1 ms. On one core the AVX2 path takes about 2.5 to 4 ms, of which streaming
+// the sphere data is about 1 ms; the rest is the plane math and the AABB pass.
+
+#include "Core/JobSystem.hpp"
+#include "Graphics/FrustumCulling.hpp"
+
+#include <spdlog/spdlog.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace Solaris::Graphics;
+
+constexpr int kIterations = 50;
+constexpr float kSceneExtent = 500.0f;
+
+// Inward planes of a symmetric perspective frustum at the origin looking down -z, in the order of
+// Vulkan::ExtractFrustumPlanes.
+std::array<glm::vec4, 6> makeFrustum(float fovY, float aspect, float zNear, float zFar) {
+    float halfY = fovY * 0.5f;
+    float halfX = std::atan(std::tan(halfY) * aspect);
+    return {
+        glm::vec4(std::cos(halfX), 0.0f, -std::sin(halfX), 0.0f),   // left
+        glm::vec4(-std::cos(halfX), 0.0f, -std::sin(halfX), 0.0f),  // right
+        glm::vec4(0.0f, std::cos(halfY), -std::sin(halfY), 0.0f),   // bottom
+        glm::vec4(0.0f, -std::cos(halfY), -std::sin(halfY), 0.0f),  // top
+        glm::vec4(0.0f, 0.0f, -1.0f, -zNear),                       // near
+        glm::vec4(0.0f, 0.0f, 1.0f, zFar),                          // far
+    };
+}
+
+void fillScene(FrustumCuller& culler, uint32_t count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-kSceneExtent, kSceneExtent);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_real_distribution<float> shape(0.2f, 1.0f);
+
+    culler.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        // A box inside its bounding sphere, like the bounds of a real mesh.
+        glm::vec3 extent = glm::vec3(shape(rng), shape(rng), shape(rng)) * size(rng);
+        (void)culler.add(glm::vec4(center, glm::length(extent)), center - extent, center + extent);
+    }
+}
+
+struct Timing {
+    double best = 0.0;
+    double median = 0.0;
+};
+
+Timing measure(FrustumCuller& culler,
+               std::span<const glm::vec4, 6> planes,
+               std::vector<uint32_t>& visible,
+               Solaris::JobSystem* jobs) {
+    std::vector<double> times;
+    culler.cull(planes, visible, jobs);  // warm up the caches and the output vector
+    for (int i = 0; i < kIterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        culler.cull(planes, visible, jobs);
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::ranges::sort(times);
+    return {times.front(), times[times.size() / 2]};
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+    uint32_t count = 1'000'000;
+    if (argc > 2) {
+        spdlog::error("Usage: {} [objects]", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc == 2) {
+        std::string_view arg = argv[1];
+        if (std::from_chars(arg.data(), arg.data() + arg.size(), count).ec != std::errc{} || count == 0) {
+            spdlog::error("Invalid object count {}", arg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        auto planes = makeFrustum(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+
+        Solaris::JobSystem jobs;
+        jobs.init();
+
+        FrustumCuller culler;
+        culler.init(FrustumCuller::Path::Scalar);
+        fillScene(culler, count);
+
+        std::vector<uint32_t> reference;
+        culler.cull(planes, reference);
+        spdlog::info("{} objects, {} visible, {} worker threads.", count, reference.size(), jobs.size());
+
+        std::vector<uint32_t> visible;
+        for (auto path : {FrustumCuller::Path::Scalar, FrustumCuller::Path::Sse41, FrustumCuller::Path::Avx2}) {
+            if (path != FrustumCuller::Path::Scalar && FrustumCuller::getBestPath() < path) {
+                spdlog::info("{:>7}: not supported by this CPU.", FrustumCuller::getPathName(path));
+                continue;
+            }
+            culler.init(path);
+
+            auto single = measure(culler, planes, visible, nullptr);
+            if (visible != reference) {
+                throw std::runtime_error(std::format("The {} path disagrees with the scalar one",
+                                                     FrustumCuller::getPathName(path)));
+            }
+            auto parallel = measure(culler, planes, visible, &jobs);
+            if (visible != reference) {
+                throw std::runtime_error(std::format("The parallel {} path disagrees with the scalar one",
+                                                     FrustumCuller::getPathName(path)));
+            }
+
+            spdlog::info("{:>7}: {:.3f} ms best, {:.3f} ms median on one thread; {:.3f} ms best, {:.3f} ms median "
+                         "across the job system.",
+                         FrustumCuller::getPathName(path), single.best, single.median, parallel.best,
+                         parallel.median);
+        }
+    } catch (std::runtime_error& err) {
+        spdlog::error("{}", err.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
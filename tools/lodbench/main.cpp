@@ -0,0 +1,135 @@
+// Measures Solaris::Graphics::LodSelector on random scenes.
+//
+//     lodbench [objects]
+//
+// Scatters `objects` (default 100k) instances of a few meshes with eight levels of detail around a camera that
+// flies through the scene, and selects their levels every frame, on one thread and across the job system. Both
+// selectors see the same camera path and must pick the same levels; the tool fails otherwise.
+
+#include "Core/JobSystem.hpp"
+#include "Graphics/LodSelection.hpp"
+
+#include <spdlog/spdlog.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace Solaris::Graphics;
+
+constexpr int kFrames = 200;
+constexpr uint32_t kMeshes = 4;
+constexpr float kSceneExtent = 500.0f;
+constexpr float kCameraSpeed = 2.0f;  // world units per frame
+
+void fillScene(LodSelector& selector, uint32_t count) {
+    // Errors roughly doubling per level, like meshconv produces, at a different base size per mesh.
+    std::array<MeshLod, kMaxMeshLods> lods{};
+    for (uint32_t mesh = 0; mesh < kMeshes; mesh++) {
+        float error = 0.001f * static_cast<float>(mesh + 1);
+        for (uint32_t level = 1; level < kMaxMeshLods; level++) {
+            lods[level].error = error;
+            error *= 2.0f;
+        }
+        (void)selector.addMesh(lods);
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-kSceneExtent, kSceneExtent);
+    std::uniform_real_distribution<float> size(0.5f, 5.0f);
+    std::uniform_int_distribution<uint32_t> mesh(0, kMeshes - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        float scale = size(rng);
+        (void)selector.addObject(mesh(rng), center, scale, scale);
+    }
+}
+
+struct Timing {
+    double best = 0.0;
+    double median = 0.0;
+};
+
+Timing summarize(std::vector<double>& times) {
+    std::ranges::sort(times);
+    return {times.front(), times[times.size() / 2]};
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+    uint32_t count = 100'000;
+    if (argc > 2) {
+        spdlog::error("Usage: {} [objects]", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc == 2) {
+        std::string_view arg = argv[1];
+        if (std::from_chars(arg.data(), arg.data() + arg.size(), count).ec != std::errc{} || count == 0) {
+            spdlog::error("Invalid object count {}", arg);
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        // 1080 pixels high with a 60 degree vertical field of view.
+        float projectionScale = 1080.0f / (2.0f * std::tan(glm::radians(60.0f) * 0.5f));
+
+        Solaris::JobSystem jobs;
+        jobs.init();
+
+        LodSelector single;
+        LodSelector parallel;
+        single.init({});
+        parallel.init({});
+        fillScene(single, count);
+        fillScene(parallel, count);
+
+        std::vector<double> singleTimes;
+        std::vector<double> parallelTimes;
+        size_t changed = 0;
+        for (int frame = 0; frame <= kFrames; frame++) {
+            glm::vec3 camera(0.0f, 0.0f, kSceneExtent - kCameraSpeed * static_cast<float>(frame));
+
+            auto start = std::chrono::steady_clock::now();
+            single.select(camera, projectionScale);
+            auto middle = std::chrono::steady_clock::now();
+            parallel.select(camera, projectionScale, &jobs);
+            auto end = std::chrono::steady_clock::now();
+
+            if (!std::ranges::equal(single.getLods(), parallel.getLods()) ||
+                !std::ranges::equal(single.getChanged(), parallel.getChanged())) {
+                throw std::runtime_error(std::format("The parallel selection disagrees in frame {}", frame));
+            }
+            // The first frame moves every object off LOD 0 and warms up the caches, it is not timed.
+            if (frame > 0) {
+                singleTimes.push_back(std::chrono::duration<double, std::milli>(middle - start).count());
+                parallelTimes.push_back(std::chrono::duration<double, std::milli>(end - middle).count());
+                changed += single.getChanged().size();
+            }
+        }
+
+        auto one = summarize(singleTimes);
+        auto all = summarize(parallelTimes);
+        spdlog::info("{} objects, {} changed levels per frame on average, {} worker threads.", count,
+                     changed / kFrames, jobs.size());
+        spdlog::info("{:.3f} ms best, {:.3f} ms median on one thread; {:.3f} ms best, {:.3f} ms median across the "
+                     "job system.",
+                     one.best, one.median, all.best, all.median);
+    } catch (std::runtime_error& err) {
+        spdlog::error("{}", err.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
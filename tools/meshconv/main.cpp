@@ -0,0 +1,331 @@
+// Converts Wavefront OBJ meshes into the binary mesh format loaded by Solaris::Graphics::MeshFile.
+//
+//     meshconv [--packed] input.obj output.smesh
+//
+// The triangles are reordered for the post-transform vertex cache and the vertices for fetch locality, with
+// duplicates merged, and the indices stored at the smallest width that fits. Coarser levels of detail are
+// generated by quadric simplification, each halving the triangles, into the same vertex and index streams.
+//
+// --packed stores positions as snorm16 relative to the mesh bounds in one stream, and octahedral normals and
+// half-float texture coordinates in a second, 16 bytes per vertex instead of 32. Both streams load into a
+// GeometryArena configured with the same two strides; depth-only passes bind just the first.
+
+#include "Graphics/MeshFile.hpp"
+#include "Graphics/MeshProcessing.hpp"
+#include "Graphics/VertexLayout.hpp"
+
+#include <spdlog/spdlog.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace Solaris::Graphics;
+
+struct ConvertedVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+};
+
+struct PackedPosition {
+    Snorm16x4 position;
+};
+
+struct PackedShading {
+    Octahedral16 normal;
+    Half2 texCoord;
+};
+
+using FullLayout = VertexLayout<ConvertedVertex>;
+using PackedLayout = VertexLayout<PackedPosition, PackedShading>;
+
+constexpr std::array kSemantics{VertexSemantic::Position, VertexSemantic::Normal, VertexSemantic::TexCoord};
+
+// Levels of detail stop once the deviation would exceed this fraction of the bounding radius.
+constexpr float kMaxLodError = 0.1f;
+
+struct ObjMesh {
+    std::vector<ConvertedVertex> vertices;
+    std::vector<uint32_t> indices;  // every level of detail, one after the other
+    std::vector<MeshLod> lods;
+    bool hasNormals = false;
+};
+
+struct Corner {
+    int position = 0;
+    int texCoord = 0;
+    int normal = 0;
+
+    bool operator==(const Corner&) const = default;
+};
+
+struct CornerHash {
+    size_t operator()(const Corner& c) const {
+        return std::hash<uint64_t>{}((uint64_t(uint32_t(c.position)) << 40) ^ (uint64_t(uint32_t(c.texCoord)) << 20) ^
+                                     uint64_t(uint32_t(c.normal)));
+    }
+};
+
+std::vector<std::string_view> split(std::string_view line, char separator) {
+    std::vector<std::string_view> parts;
+    while (!line.empty()) {
+        auto end = line.find(separator);
+        auto part = line.substr(0, end);
+        if (!part.empty() || separator == '/') {
+            parts.push_back(part);
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        line.remove_prefix(end + 1);
+    }
+    return parts;
+}
+
+float toFloat(std::string_view text) {
+    float value = 0.0f;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+// OBJ indices are 1-based, negative ones count back from the last element read so far.
+int toIndex(std::string_view text, size_t count) {
+    if (text.empty()) {
+        return -1;
+    }
+    int value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    int index = value < 0 ? static_cast<int>(count) + value : value - 1;
+    if (index < 0 || index >= static_cast<int>(count)) {
+        throw std::runtime_error(std::format("OBJ index {} out of range", text));
+    }
+    return index;
+}
+
+ObjMesh loadObj(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error(std::format("Failed to open {}", path.string()));
+    }
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::unordered_map<Corner, uint32_t, CornerHash> unique;
+    ObjMesh mesh{};
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::ranges::replace(line, '\t', ' ');
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        auto parts = split(line, ' ');
+        if (parts.empty()) {
+            continue;
+        }
+        auto tag = parts[0];
+        if (tag == "v" && parts.size() >= 4) {
+            positions.emplace_back(toFloat(parts[1]), toFloat(parts[2]), toFloat(parts[3]));
+        } else if (tag == "vn" && parts.size() >= 4) {
+            normals.emplace_back(toFloat(parts[1]), toFloat(parts[2]), toFloat(parts[3]));
+        } else if (tag == "vt" && parts.size() >= 3) {
+            // OBJ puts the origin at the bottom left, Vulkan samples from the top left.
+            texCoords.emplace_back(toFloat(parts[1]), 1.0f - toFloat(parts[2]));
+        } else if (tag == "f" && parts.size() >= 4) {
+            std::vector<uint32_t> polygon;
+            for (size_t i = 1; i < parts.size(); i++) {
+                auto fields = split(parts[i], '/');
+                Corner corner{toIndex(fields[0], positions.size()),
+                              fields.size() > 1 ? toIndex(fields[1], texCoords.size()) : -1,
+                              fields.size() > 2 ? toIndex(fields[2], normals.size()) : -1};
+
+                auto [it, inserted] = unique.try_emplace(corner, static_cast<uint32_t>(mesh.vertices.size()));
+                if (inserted) {
+                    ConvertedVertex vertex{};
+                    vertex.position = positions[corner.position];
+                    vertex.normal = corner.normal >= 0 ? normals[corner.normal] : glm::vec3(0.0f);
+                    vertex.texCoord = corner.texCoord >= 0 ? texCoords[corner.texCoord] : glm::vec2(0.0f);
+                    mesh.hasNormals = mesh.hasNormals || corner.normal >= 0;
+                    mesh.vertices.push_back(vertex);
+                }
+                polygon.push_back(it->second);
+            }
+            // Polygons are assumed convex and fanned out from their first corner.
+            for (size_t i = 1; i + 1 < polygon.size(); i++) {
+                mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i], polygon[i + 1]});
+            }
+        }
+    }
+    return mesh;
+}
+
+// Area-weighted vertex normals, for files that have none.
+void computeNormals(ObjMesh& mesh) {
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+        auto& a = mesh.vertices[mesh.indices[i]];
+        auto& b = mesh.vertices[mesh.indices[i + 1]];
+        auto& c = mesh.vertices[mesh.indices[i + 2]];
+        glm::vec3 normal = glm::cross(b.position - a.position, c.position - a.position);
+        a.normal += normal;
+        b.normal += normal;
+        c.normal += normal;
+    }
+    for (auto& vertex : mesh.vertices) {
+        float length = glm::length(vertex.normal);
+        vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+}
+
+template <typename T>
+std::vector<std::byte> toBytes(const std::vector<T>& values) {
+    std::vector<std::byte> bytes(values.size() * sizeof(T));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+}
+
+template <typename T>
+std::vector<std::byte> narrowIndices(const std::vector<uint32_t>& indices) {
+    return toBytes(std::vector<T>(indices.begin(), indices.end()));
+}
+
+std::vector<glm::vec3> getPositions(const ObjMesh& obj) {
+    std::vector<glm::vec3> positions;
+    positions.reserve(obj.vertices.size());
+    for (const auto& vertex : obj.vertices) {
+        positions.push_back(vertex.position);
+    }
+    return positions;
+}
+
+// Appends coarser versions of LOD 0, each simplified from LOD 0 so its error is measured against the full mesh.
+void generateLods(ObjMesh& obj) {
+    auto positions = getPositions(obj);
+    float maxError = ComputeBounds(positions).radius * kMaxLodError;
+    auto full = obj.indices;
+    obj.lods = {{0, static_cast<uint32_t>(full.size()), 0.0f, 0}};
+
+    size_t target = full.size();
+    while (obj.lods.size() < kMaxMeshLods) {
+        target = target / 6 * 3;
+        auto lod = SimplifyMesh(full, positions, target, maxError);
+        // Give up once simplification stalls on locked vertices or the error limit.
+        if (lod.indices.empty() || lod.indices.size() > obj.lods.back().indexCount * 9 / 10) {
+            break;
+        }
+        OptimizeVertexCache(lod.indices, static_cast<uint32_t>(positions.size()));
+        obj.lods.push_back({static_cast<uint32_t>(obj.indices.size()), static_cast<uint32_t>(lod.indices.size()),
+                            lod.error, 0});
+        obj.indices.insert(obj.indices.end(), lod.indices.begin(), lod.indices.end());
+        spdlog::info("LOD {}: {} triangles, error {:.4g}.", obj.lods.size() - 1, lod.indices.size() / 3, lod.error);
+    }
+}
+
+void optimize(ObjMesh& obj) {
+    auto vertexCount = static_cast<uint32_t>(obj.vertices.size());
+    auto before = AnalyzeVertexCache(obj.indices, vertexCount);
+
+    auto unique = DeduplicateVertices(std::as_bytes(std::span(obj.vertices)), sizeof(ConvertedVertex));
+    obj.vertices = RemapVertices(std::span<const ConvertedVertex>(obj.vertices), unique);
+    RemapIndices(obj.indices, unique);
+
+    OptimizeVertexCache(obj.indices, unique.vertexCount);
+    generateLods(obj);
+    // LOD 0 comes first, so its vertices are fetched front to back; coarser levels use a subset of them.
+    auto fetch = OptimizeVertexFetch(obj.indices, unique.vertexCount);
+    obj.vertices = RemapVertices(std::span<const ConvertedVertex>(obj.vertices), fetch);
+    RemapIndices(obj.indices, fetch);
+
+    auto after = AnalyzeVertexCache(std::span(obj.indices).first(obj.lods[0].indexCount), fetch.vertexCount);
+    spdlog::info("Vertex cache: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}; {} duplicate and {} unused vertices "
+                 "removed.",
+                 before.acmr, after.acmr, before.atvr, after.atvr, vertexCount - unique.vertexCount,
+                 unique.vertexCount - fetch.vertexCount);
+}
+
+MeshData convert(ObjMesh& obj, bool packed) {
+    if (!obj.hasNormals) {
+        computeNormals(obj);
+    }
+    optimize(obj);
+    auto positions = getPositions(obj);
+
+    MeshData mesh{};
+    mesh.vertexCount = static_cast<uint32_t>(obj.vertices.size());
+    mesh.bounds = ComputeBounds(positions);
+    if (packed) {
+        std::vector<PackedPosition> packedPositions;
+        std::vector<PackedShading> packedShading;
+        for (const auto& vertex : obj.vertices) {
+            packedPositions.push_back({PackPosition(vertex.position, mesh.bounds)});
+            packedShading.push_back({PackOctahedral(vertex.normal), PackHalf2(vertex.texCoord)});
+        }
+        mesh.attributes = PackedLayout::toMeshAttributes(kSemantics);
+        mesh.streamStrides = {PackedLayout::kStrides.begin(), PackedLayout::kStrides.end()};
+        mesh.streams = {toBytes(packedPositions), toBytes(packedShading)};
+    } else {
+        mesh.attributes = FullLayout::toMeshAttributes(kSemantics);
+        mesh.streamStrides = {FullLayout::kStrides.begin(), FullLayout::kStrides.end()};
+        mesh.streams = {toBytes(obj.vertices)};
+    }
+
+    // The runtime widens 8-bit indices on devices without VK_KHR_index_type_uint8.
+    if (mesh.vertexCount <= 0x100) {
+        mesh.indexSize = 1;
+        mesh.indices = narrowIndices<uint8_t>(obj.indices);
+    } else if (mesh.vertexCount <= 0x10000) {
+        mesh.indexSize = 2;
+        mesh.indices = narrowIndices<uint16_t>(obj.indices);
+    } else {
+        mesh.indexSize = 4;
+        mesh.indices = toBytes(obj.indices);
+    }
+    mesh.lods = obj.lods;
+
+    auto meshlets = BuildMeshlets(std::span(obj.indices).first(obj.lods[0].indexCount), positions);
+    mesh.meshlets = std::move(meshlets.meshlets);
+    mesh.meshletVertices = std::move(meshlets.vertices);
+    mesh.meshletTriangles = std::move(meshlets.triangles);
+    return mesh;
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+    bool packed = argc == 4 && std::string_view(argv[1]) == "--packed";
+    if (argc != 3 && !packed) {
+        spdlog::error("Usage: {} [--packed] input.obj output.smesh", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char* input = argv[argc - 2];
+    const char* output = argv[argc - 1];
+
+    try {
+        auto obj = loadObj(input);
+        if (obj.indices.empty()) {
+            throw std::runtime_error(std::format("{} has no triangles", input));
+        }
+        auto mesh = convert(obj, packed);
+        WriteMeshFile(output, mesh);
+
+        spdlog::info("{}: {} vertices, {} triangles, {} levels of detail, {} meshlets.", output, mesh.vertexCount,
+                     mesh.lods[0].indexCount / 3, mesh.lods.size(), mesh.meshlets.size());
+    } catch (std::runtime_error& err) {
+        spdlog::error("{}", err.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}